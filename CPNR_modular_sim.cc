@@ -1,39 +1,187 @@
 // CPNR_modular_sim.cc
 // 시뮬레이션의 시작점(entry point)이며, 전체 실행 흐름을 제어합니다.
+//
+// 사용법: CPNR_modular_sim [매크로] [-m 매크로] [-t 스레드수] [-r serial|mt|tasking|adaptive] [-s 시드]
+//                          [-n 이벤트수] [-o 출력이름] [-e eventModulo] [-p 프로파일] [-c 캐시]
+//                          [-f 프로세스수] [-i 첫이벤트ID]
+// 인자가 없으면 GUI 모드로 실행합니다. 자세한 설명은 -h 또는 README의 3.2절을 참고하십시오.
+// 배치 모드에서는 시각화와 스코어링 같은 대화형 구성요소를 만들지 않습니다.
 
 #include "G4RunManagerFactory.hh"
+#include "G4MTRunManager.hh"
 #include "G4UImanager.hh"
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 #include "G4Threading.hh"
 #include "G4ScoringManager.hh"
+#include "Randomize.hh"
+#include "TROOT.h"
 
 #include "DetectorConstruction.hh"
 #include "MyShieldingPhysList.hh" 
 #include "ActionInitialization.hh"
+#include "AdaptiveTaskRunManager.hh"
+#include "EventSeeder.hh"
+#include "ForkRunManager.hh"
+#include "PhysicsTableCache.hh"
+#include "StartupTimer.hh"
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+namespace {
+
+// -p 로 고르는 물리/광학 프로파일. 커널 초기화 뒤, 매크로보다 먼저 적용되는 명령어 묶음입니다.
+const std::map<G4String, std::vector<G4String>> kProfiles = {
+  // 기본 구성: 세그먼트/PMT 광학 Fast Simulation 사용
+  {"default", {}},
+  // 광학 광자를 만들지 않습니다. 에너지 증착과 중성자 포획만 필요한 연구용
+  {"noOptics", {"/process/inactivate Scintillation", "/process/inactivate Cerenkov"}},
+  // 광학 Fast Simulation 모델을 끄고 Geant4가 광자를 직접 추적합니다 (검증용, 느림)
+  {"detailedOptics", {"/param/InActivateModel SegmentOpticalModel", "/param/InActivateModel PMTOpticalModel"}},
+};
+
+void PrintUsage()
+{
+  G4cerr << "usage: CPNR_modular_sim [macro] [options]\n"
+         << "  -m <macro>      batch macro to execute (same as the positional argument)\n"
+         << "  -t <n>          number of worker threads (default: all cores)\n"
+         << "  -r <type>       run manager: serial, mt, tasking, adaptive (default: Geant4 default, G4RUN_MANAGER_TYPE)\n"
+         << "  -s <seed>       master random seed\n"
+         << "  -n <events>     run /run/beamOn <events> after the macro\n"
+         << "  -o <name>       output file name without .root (/myApp/output/fileName)\n"
+         << "  -e <n>          fixed event modulo for MT/tasking (turns adaptive batching off)\n"
+         << "  -p <profile>    physics/optics profile: default, noOptics, detailedOptics\n"
+         << "  -c <dir>        store/retrieve physics tables in this cache directory\n"
+         << "  -f <n>          initialize once, then fork n processes that split the -n events\n"
+         << "  -i <id>         event ID of the first event (serial; keeps IDs of split jobs disjoint)\n"
+         << "  -h              print this help\n"
+         << "Without a macro or -n the GUI is started." << G4endl;
+}
+
+} // namespace
 
 int main(int argc, char** argv)
 {
-  // UI 세션 감지 (터미널 인자가 없으면 GUI 모드로 판단)
+  StartupTimer::Start();
+  // 쓰기 스레드와 perThread 모드의 워커들이 ROOT를 함께 쓰므로, 어떤 스레드도 시작하기 전에 한 번만 켭니다.
+  ROOT::EnableThreadSafety();
+
+  // --- 명령행 인자 처리 ---
+  G4String macro;
+  G4String output;
+  G4String profile = "default";
+  G4String runManagerName;
+  G4String tableCache;
+  G4int nThreads = 0;
+  G4int nEvents = 0;
+  G4int eventModulo = 0;
+  G4int nProcesses = 0;
+  G4int firstEventID = 0;
+  long seed = 0;
+
+  for (G4int i = 1; i < argc; ++i) {
+    const G4String arg = argv[i];
+    const G4bool hasValue = (i + 1 < argc);
+    if (arg == "-h" || arg == "--help") { PrintUsage(); return 0; }
+    else if (arg == "-m" && hasValue) macro = argv[++i];
+    else if (arg == "-t" && hasValue) nThreads = std::atoi(argv[++i]);
+    else if (arg == "-r" && hasValue) runManagerName = argv[++i];
+    else if (arg == "-s" && hasValue) seed = std::atol(argv[++i]);
+    else if (arg == "-n" && hasValue) nEvents = std::atoi(argv[++i]);
+    else if (arg == "-o" && hasValue) output = argv[++i];
+    else if (arg == "-e" && hasValue) eventModulo = std::atoi(argv[++i]);
+    else if (arg == "-p" && hasValue) profile = argv[++i];
+    else if (arg == "-c" && hasValue) tableCache = argv[++i];
+    else if (arg == "-f" && hasValue) nProcesses = std::atoi(argv[++i]);
+    else if (arg == "-i" && hasValue) firstEventID = std::atoi(argv[++i]);
+    else if (arg[0] != '-' && macro.empty()) macro = arg; // 예전 방식: 첫 번째 인자가 매크로
+    else { PrintUsage(); return 1; }
+  }
+
+  if (kProfiles.find(profile) == kProfiles.end()) {
+    G4cerr << "CPNR_modular_sim: unknown profile " << profile << G4endl;
+    PrintUsage();
+    return 1;
+  }
+
+  if (nProcesses > 0 && (nEvents <= 0 || !runManagerName.empty())) {
+    G4cerr << "CPNR_modular_sim: -f needs -n and cannot be combined with -r" << G4endl;
+    PrintUsage();
+    return 1;
+  }
+  if (firstEventID > 0 && !runManagerName.empty() && runManagerName != "serial") {
+    G4cerr << "CPNR_modular_sim: -i is only supported with the serial run manager" << G4endl;
+    PrintUsage();
+    return 1;
+  }
+
+  G4RunManagerType runManagerType = G4RunManagerType::Default;
+  if (runManagerName == "serial") runManagerType = G4RunManagerType::Serial;
+  else if (runManagerName == "mt") runManagerType = G4RunManagerType::MT;
+  else if (runManagerName == "tasking" || runManagerName == "adaptive") runManagerType = G4RunManagerType::Tasking;
+  else if (!runManagerName.empty()) {
+    G4cerr << "CPNR_modular_sim: unknown run manager type " << runManagerName << G4endl;
+    PrintUsage();
+    return 1;
+  }
+
+  // UI 세션 감지 (매크로도 이벤트 수도 없으면 GUI 모드로 판단)
   G4UIExecutive* ui = nullptr;
-  if (argc == 1) {
+  if (macro.empty() && nEvents <= 0) {
     ui = new G4UIExecutive(argc, argv);
+    // GUI에서는 따로 지정하지 않는 한 순차 모드로 실행합니다.
+    if (runManagerName.empty()) runManagerType = G4RunManagerType::SerialOnly;
   }
 
   // 실행 모드에 따라 적합한 RunManager 생성
-  auto* runManager = G4RunManagerFactory::CreateRunManager(
-      (ui) ? G4RunManagerType::SerialOnly : G4RunManagerType::Default
-  );
-  if (!ui) {
-    runManager->SetNumberOfThreads(G4Threading::G4GetNumberOfCores());
+  // -r adaptive는 측정한 이벤트 비용으로 묶음 크기를 정하는 AdaptiveTaskRunManager를 씁니다.
+  // -r이 없으면 G4RunManagerFactory가 기본 종류(G4RUN_MANAGER_TYPE 환경 변수 포함)를 정합니다.
+  G4RunManager* runManager = nullptr;
+  {
+    StartupTimer::Scope timer("run manager");
+    if (nProcesses > 0 || firstEventID > 0) {
+      // fork 모드: 순차 모드로 모두 초기화한 뒤 프로세스를 나눕니다.
+      // -i만 주면 fork 없이 이벤트 ID가 firstEventID부터 시작하는 순차 실행입니다.
+      auto forkRunManager = new ForkRunManager();
+      forkRunManager->SetFirstEventID(firstEventID);
+      forkRunManager->SetSetupOnly(nProcesses > 0);
+      runManager = forkRunManager;
+    }
+    else if (runManagerName == "adaptive") {
+      runManager = new AdaptiveTaskRunManager();
+    }
+    else {
+      runManager = G4RunManagerFactory::CreateRunManager(runManagerType);
+    }
   }
+  if ((!ui || nThreads > 0) && !dynamic_cast<ForkRunManager*>(runManager)) {
+    // 스케줄러가 할당한 코어 수에 맞추어 공유 노드를 과점유하지 않도록 합니다.
+    runManager->SetNumberOfThreads(nThreads > 0 ? nThreads : G4Threading::G4GetNumberOfCores());
+  }
+  if (eventModulo > 0) {
+    // G4TaskRunManager도 G4MTRunManager를 상속합니다. 순차 모드에서는 의미가 없으므로 무시합니다.
+    if (auto mtRunManager = dynamic_cast<G4MTRunManager*>(runManager)) mtRunManager->SetEventModulo(eventModulo);
+    // 고정값을 직접 지정했으면 적응형 묶음 크기 조절을 끕니다.
+    if (dynamic_cast<AdaptiveTaskRunManager*>(runManager)) {
+      G4UImanager::GetUIpointer()->ApplyCommand("/myApp/run/adaptiveBatching false");
+    }
+  }
+  if (seed > 0) G4Random::setTheSeed(seed);
+  // 이벤트 시드 모드의 마스터 시드는 여기서 정해진 시드입니다 (/myApp/random/).
+  auto eventSeeder = new EventSeeder();
+  // MT에서는 Initialize() 안에서 물리 테이블을 만들므로 그 전에 등록해야 합니다.
+  if (!tableCache.empty()) new PhysicsTableCache(tableCache);
 
-  // 스코어링 매니저 활성화
-  G4ScoringManager::GetScoringManager();
-
-  // 시각화 관리자 생성 및 초기화
-  G4VisManager* visManager = new G4VisExecutive;
-  visManager->Initialize();
+  // 시각화 관리자와 스코어링 매니저는 GUI 모드에서만 만듭니다.
+  G4VisManager* visManager = nullptr;
+  if (ui) {
+    StartupTimer::Scope timer("visualization");
+    G4ScoringManager::GetScoringManager();
+    visManager = new G4VisExecutive;
+    visManager->Initialize();
+  }
 
   // 필수 사용자 클래스들을 RunManager에 등록
   runManager->SetUserInitialization(new DetectorConstruction());
@@ -46,7 +194,12 @@ int main(int argc, char** argv)
   // UI 관리자 포인터 가져오기
   G4UImanager* UImanager = G4UImanager::GetUIpointer();
 
+  // 명령행 설정은 매크로보다 먼저 적용되므로, 매크로에서 같은 명령어로 덮어쓸 수 있습니다.
+  if (!output.empty()) UImanager->ApplyCommand("/myApp/output/fileName " + output);
+  for (const auto& command : kProfiles.at(profile)) UImanager->ApplyCommand(command);
+
   // 실행 모드에 따라 적절한 매크로 실행
+  G4int status = 0;
   if (ui) {
     // ## 인터랙티브(GUI) 모드 ##
     UImanager->ApplyCommand("/control/execute vis.mac"); // GUI용 기본 매크로
@@ -55,14 +208,21 @@ int main(int argc, char** argv)
   }
   else {
     // ## 배치 모드 ##
-    G4String command = "/control/execute ";
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command + fileName);
+    if (!macro.empty()) UImanager->ApplyCommand("/control/execute " + macro);
+    auto forkRunManager = dynamic_cast<ForkRunManager*>(runManager);
+    if (forkRunManager && nProcesses > 0) {
+      // 자식 프로세스도 자신의 몫을 끝낸 뒤 여기로 돌아와 아래의 정리 과정을 거칩니다.
+      status = forkRunManager->RunForked(nProcesses, nEvents);
+    }
+    else if (nEvents > 0) {
+      UImanager->ApplyCommand("/run/beamOn " + std::to_string(nEvents));
+    }
   }
 
   // 프로그램 종료 전 메모리 해제
+  delete eventSeeder;
   delete visManager;
   delete runManager;
 
-  return 0;
+  return status;
 }
@@ -0,0 +1,347 @@
+// cpnr_driver.cc
+// 큰 생산 작업을 이 컴퓨터 안의 독립된 시뮬레이션 프로세스 여러 개로 나누어 돌리고, 끝나면 출력을 합치는 도구입니다.
+//
+// 사용법: cpnr_driver -n 전체이벤트수 -j 작업수 -o 출력이름 [-m 매크로] [-s 시드] [-k 체크포인트간격]
+//                     [-x 시뮬레이션실행파일] [-M 병합실행파일] [-- 시뮬레이션에 넘길 인자 ...]
+//   -n N : 전체 이벤트 수. 작업 k는 이벤트 ID [k*N/j, (k+1)*N/j)를 실행합니다.
+//   -j J : 작업 수 (모두 동시에 순차 모드로 실행합니다).
+//   -s S : 기준 시드. 작업마다 겹치지 않는 시드를 여기서 만들므로, 같은 S로 다시 돌리면 같은 결과가 나옵니다.
+//   -k K : 작업마다 이벤트 K개마다 체크포인트를 남깁니다. 중단된 생산은 같은 명령으로 다시 실행하면
+//          끝난 작업은 건너뛰고, 중단된 작업은 체크포인트에서 이어서 실행합니다.
+//   -m M : 작업마다 먼저 실행할 설정 매크로. 이벤트 수는 -n으로 정하므로 /run/beamOn 줄은 빼고 씁니다.
+//
+// 모든 작업이 성공하면 이벤트 TTree는 cpnr_merge로 <출력이름>.root에, 히스토그램은 <출력이름>_histos.root에 합칩니다.
+// 작업별 시드와 이벤트 구간은 <출력이름>_jobs.txt에 남습니다.
+
+#include "TFileMerger.h"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Job {
+  int index = 0;
+  long firstEvent = 0;
+  long nEvents = 0;
+  long seed = 0;
+  std::string name;  // 출력 이름 (<출력이름>_j<k>)
+  pid_t pid = -1;
+  bool done = false;
+  bool failed = false;
+};
+
+// 기준 시드와 작업 번호에서 작업의 시드를 만듭니다 (SplitMix64). 작업마다 충분히 떨어진 양수 시드가 나옵니다.
+long JobSeed(long baseSeed, int index)
+{
+  std::uint64_t z = static_cast<std::uint64_t>(baseSeed) + 0x9E3779B97F4A7C15ULL * (index + 1);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+  return static_cast<long>(z % 2147483646ULL) + 1;
+}
+
+// 실행 파일을 기본값으로 찾을 때는 cpnr_driver와 같은 디렉토리를 봅니다.
+std::string SiblingExecutable(const char* argv0, const std::string& name)
+{
+  const fs::path self(argv0);
+  return self.has_parent_path() ? (self.parent_path() / name).string() : name;
+}
+
+// args[0]을 실행하고, log가 비어 있지 않으면 표준 출력과 오류를 그 파일로 보냅니다.
+pid_t Launch(const std::vector<std::string>& args, const std::string& log)
+{
+  const pid_t pid = fork();
+  if (pid != 0) return pid;
+
+  if (!log.empty()) {
+    const int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd >= 0) {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+  }
+  std::vector<char*> argv;
+  for (const auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+  execvp(argv[0], argv.data());
+  std::perror(argv[0]);
+  _exit(127);
+}
+
+bool RunAndWait(const std::vector<std::string>& args)
+{
+  const pid_t pid = Launch(args, "");
+  int status = 0;
+  return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// 로그에서 Geant4가 /run/printProgress로 찍은 마지막 "--> Event N starts"를 찾아 끝난 이벤트 수를 추정합니다.
+long ProcessedEvents(const Job& job)
+{
+  std::ifstream log(job.name + ".log");
+  if (!log) return 0;
+  log.seekg(0, std::ios::end);
+  const std::streamoff size = log.tellg();
+  const std::streamoff tail = std::min<std::streamoff>(size, 64 * 1024);
+  log.seekg(size - tail);
+  std::string text(static_cast<std::size_t>(tail), '\0');
+  log.read(&text[0], tail);
+
+  const std::string marker = "--> Event ";
+  const std::size_t pos = text.rfind(marker);
+  if (pos == std::string::npos) return 0;
+  const long eventID = std::atol(text.c_str() + pos + marker.size());
+  return std::clamp(eventID - job.firstEvent, 0L, job.nEvents);
+}
+
+// 사용자 매크로를 읽어 작업 매크로에 넣을 설정 명령만 남깁니다. 이벤트 수는 드라이버가 -n으로 정하므로
+// /run/beamOn 줄은 빼고 경고합니다. 매크로 안에서 /control/execute로 부르는 다른 매크로는 검사하지 않으니,
+// 그 매크로들은 설정만 담고 있어야 합니다.
+bool ReadSetupMacro(const std::string& macro, std::string& commands)
+{
+  commands.clear();
+  if (macro.empty()) return true;
+  std::ifstream in(macro);
+  if (!in) {
+    std::cerr << "cpnr_driver: cannot read macro " << macro << std::endl;
+    return false;
+  }
+  std::string line;
+  for (int number = 1; std::getline(in, line); ++number) {
+    const std::size_t first = line.find_first_not_of(" \t");
+    if (first != std::string::npos && line.compare(first, 11, "/run/beamOn") == 0) {
+      std::cerr << "cpnr_driver: " << macro << ":" << number << ": /run/beamOn removed from job macros" << std::endl;
+      continue;
+    }
+    commands += line + "\n";
+  }
+  return true;
+}
+
+// 설정 명령 뒤에 출력 이름, 진행 상황 출력과 체크포인트 설정을 덧붙이는 작업 매크로를 씁니다.
+// 설정 매크로가 /myApp/output/fileName을 바꿔도 작업마다 자신의 이름으로 쓰도록 출력 이름을 다시 정합니다.
+// 이벤트 시드 모드(/myApp/random/eventSeeding true)에서는 모든 작업이 기준 시드를 마스터 시드로 쓰므로,
+// 결과가 작업 수와 상관없이 같습니다.
+void WriteJobMacro(const Job& job, const std::string& setup, long baseSeed, long checkpointInterval, bool resume)
+{
+  std::ofstream out(job.name + ".mac");
+  out << setup;
+  out << "/myApp/output/fileName " << job.name << "\n";
+  out << "/myApp/random/masterSeed " << baseSeed << "\n";
+  out << "/run/printProgress " << std::max(1L, job.nEvents / 100) << "\n";
+  if (checkpointInterval > 0) {
+    out << "/myApp/checkpoint/interval " << checkpointInterval << "\n";
+    if (resume) out << "/myApp/checkpoint/resume true\n";
+  }
+}
+
+// <base>.root가 있으면 그것을, 없으면 파일 분할로 생긴 <base>_0000.root, <base>_0001.root, ...를 더합니다.
+void AddRootFiles(const std::string& base, std::vector<std::string>& files)
+{
+  if (fs::exists(base + ".root")) {
+    files.push_back(base + ".root");
+    return;
+  }
+  for (int chunk = 0;; ++chunk) {
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "_%04d", chunk);
+    if (!fs::exists(base + suffix + ".root")) break;
+    files.push_back(base + suffix + ".root");
+  }
+}
+
+// 작업 하나가 남기는 출력 파일을 이름 규칙대로 찾습니다: <이름>, 재개한 런의 <이름>_resume<N>,
+// 각각의 스레드별 출력 _t<k>, 그리고 파일 분할 번호. 같은 디렉토리의 다른 생산이나 지난 생산의 파일은 섞이지 않습니다.
+void JobOutputs(const Job& job, std::vector<std::string>& trees, std::vector<std::string>& histograms)
+{
+  std::vector<std::string> bases = {job.name};
+  for (int resume = 1;; ++resume) {
+    const std::string base = job.name + "_resume" + std::to_string(resume);
+    if (!fs::exists(base + ".root") && !fs::exists(base + "_0000.root") && !fs::exists(base + "_t0.root")
+        && !fs::exists(base + "_t0_0000.root") && !fs::exists(base + "_histos.root")) break;
+    bases.push_back(base);
+  }
+  for (const auto& base : bases) {
+    AddRootFiles(base, trees);
+    for (int thread = 0;; ++thread) {
+      const std::string threadBase = base + "_t" + std::to_string(thread);
+      const std::size_t before = trees.size();
+      AddRootFiles(threadBase, trees);
+      if (trees.size() == before) break;
+    }
+    if (fs::exists(base + "_histos.root")) histograms.push_back(base + "_histos.root");
+  }
+}
+
+bool MergeHistograms(const std::vector<std::string>& inputs, const std::string& output)
+{
+  if (inputs.empty()) return true;
+  TFileMerger merger(false, false);
+  merger.SetPrintLevel(0);
+  if (!merger.OutputFile(output.c_str(), "RECREATE")) return false;
+  for (const auto& input : inputs) {
+    if (!merger.AddFile(input.c_str(), false)) return false;
+  }
+  return merger.Merge();
+}
+
+void Usage()
+{
+  std::cerr << "usage: cpnr_driver -n events -j jobs -o output [-m macro] [-s seed] [-k checkpointInterval]\n"
+            << "                   [-x simulation] [-M cpnr_merge] [-- simulation arguments ...]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  long nEvents = 0;
+  int nJobs = 0;
+  long baseSeed = 12345;
+  long checkpointInterval = 0;
+  std::string output;
+  std::string macro;
+  std::string simulation = SiblingExecutable(argv[0], "CPNR_modular_sim");
+  std::string merge = SiblingExecutable(argv[0], "cpnr_merge");
+  std::vector<std::string> extraArgs;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = (i + 1 < argc);
+    if (arg == "--") { extraArgs.assign(argv + i + 1, argv + argc); break; }
+    else if (arg == "-n" && hasValue) nEvents = std::atol(argv[++i]);
+    else if (arg == "-j" && hasValue) nJobs = std::atoi(argv[++i]);
+    else if (arg == "-o" && hasValue) output = argv[++i];
+    else if (arg == "-m" && hasValue) macro = argv[++i];
+    else if (arg == "-s" && hasValue) baseSeed = std::atol(argv[++i]);
+    else if (arg == "-k" && hasValue) checkpointInterval = std::atol(argv[++i]);
+    else if (arg == "-x" && hasValue) simulation = argv[++i];
+    else if (arg == "-M" && hasValue) merge = argv[++i];
+    else { Usage(); return 1; }
+  }
+  if (nEvents <= 0 || nJobs <= 0 || output.empty()) {
+    Usage();
+    return 1;
+  }
+  nJobs = static_cast<int>(std::min<long>(nJobs, nEvents));
+
+  std::string setup;
+  if (!ReadSetupMacro(macro, setup)) return 1;
+
+  // --- 작업 나누기 ---
+  std::vector<Job> jobs(nJobs);
+  std::ofstream jobList(output + "_jobs.txt");
+  jobList << "# job firstEvent nEvents seed\n";
+  for (int k = 0; k < nJobs; ++k) {
+    Job& job = jobs[k];
+    job.index = k;
+    job.firstEvent = nEvents * k / nJobs;
+    job.nEvents = nEvents * (k + 1) / nJobs - job.firstEvent;
+    job.seed = JobSeed(baseSeed, k);
+    job.name = output + "_j" + std::to_string(k);
+    jobList << k << " " << job.firstEvent << " " << job.nEvents << " " << job.seed << "\n";
+  }
+  jobList.close();
+
+  // --- 실행 (이미 끝난 작업은 건너뜁니다) ---
+  int running = 0;
+  for (auto& job : jobs) {
+    if (fs::exists(job.name + ".done")) {
+      job.done = true;
+      std::cout << "cpnr_driver: job " << job.index << " already finished, skipped." << std::endl;
+      continue;
+    }
+    // 작업마다 /run/beamOn을 한 번만 하므로 체크포인트는 런 0의 것입니다.
+    const bool resume = checkpointInterval > 0 && fs::exists(job.name + "_run0.ckpt");
+    if (!resume) {
+      // 처음부터 다시 도는 작업은 지난 생산이 남긴 출력(_resume<N> 등)이 병합에 섞이지 않도록 먼저 지웁니다.
+      std::vector<std::string> stale;
+      JobOutputs(job, stale, stale);
+      for (const auto& file : stale) fs::remove(file);
+    }
+    WriteJobMacro(job, setup, baseSeed, checkpointInterval, resume);
+
+    std::vector<std::string> args = {simulation, "-r", "serial", "-s", std::to_string(job.seed),
+                                     "-i", std::to_string(job.firstEvent), "-o", job.name,
+                                     "-m", job.name + ".mac", "-n", std::to_string(job.nEvents)};
+    args.insert(args.end(), extraArgs.begin(), extraArgs.end());
+    job.pid = Launch(args, job.name + ".log");
+    if (job.pid < 0) {
+      job.failed = true;
+      std::cerr << "cpnr_driver: could not start job " << job.index << std::endl;
+      continue;
+    }
+    ++running;
+    std::cout << "cpnr_driver: job " << job.index << (resume ? " resumed" : " started") << " (events "
+              << job.firstEvent << "-" << job.firstEvent + job.nEvents - 1 << ", seed " << job.seed << ")" << std::endl;
+  }
+
+  // --- 진행 상황 감시 ---
+  const auto start = std::chrono::steady_clock::now();
+  while (running > 0) {
+    std::this_thread::sleep_for(std::chrono::seconds(10));
+    long processed = 0;
+    for (auto& job : jobs) {
+      if (job.pid > 0 && !job.done && !job.failed) {
+        int status = 0;
+        if (waitpid(job.pid, &status, WNOHANG) == job.pid) {
+          --running;
+          if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            job.done = true;
+            std::ofstream(job.name + ".done") << job.seed << "\n";
+          }
+          else {
+            job.failed = true;
+            std::cerr << "cpnr_driver: job " << job.index << " failed, see " << job.name << ".log" << std::endl;
+          }
+        }
+      }
+      processed += job.done ? job.nEvents : ProcessedEvents(job);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "cpnr_driver: " << processed << " / " << nEvents << " events (" << 100. * processed / nEvents
+              << " %), " << running << " jobs running, " << static_cast<long>(elapsed.count()) << " s" << std::endl;
+  }
+
+  if (std::any_of(jobs.begin(), jobs.end(), [](const Job& job) { return !job.done; })) {
+    std::cerr << "cpnr_driver: some jobs failed; run the same command again to finish them." << std::endl;
+    return 1;
+  }
+
+  // --- 출력 병합 ---
+  std::vector<std::string> trees;
+  std::vector<std::string> histograms;
+  for (const auto& job : jobs) JobOutputs(job, trees, histograms);
+
+  std::vector<std::string> mergeArgs = {merge, "-j", std::to_string(std::min(nJobs, 4)), "-o", output + ".root"};
+  mergeArgs.insert(mergeArgs.end(), trees.begin(), trees.end());
+  if (!RunAndWait(mergeArgs)) {
+    std::cerr << "cpnr_driver: merging event trees failed" << std::endl;
+    return 1;
+  }
+  if (!MergeHistograms(histograms, output + "_histos.root")) {
+    std::cerr << "cpnr_driver: merging histograms failed" << std::endl;
+    return 1;
+  }
+  std::cout << "cpnr_driver: " << nEvents << " events in " << nJobs << " jobs merged into " << output
+            << ".root and " << output << "_histos.root" << std::endl;
+  return 0;
+}
@@ -0,0 +1,207 @@
+// cpnr_merge.cc
+// perThread 출력 모드(/myApp/output/mode perThread)가 만든 cpnr_modular_sim_tN.root 파일들을
+// 하나의 파일로 합치고, 이벤트 단위 색인(EventIndex TTree)을 만드는 후처리 도구입니다.
+//
+// 사용법: cpnr_merge [-j 병렬작업수] [-d] -o 출력.root 입력.root ... (입력에 '*' 패턴 사용 가능)
+//   -j N : 입력을 N개의 묶음으로 나누어 동시에 병합한 뒤 마지막에 한 번 더 합칩니다.
+//   -d   : 병합과 색인 생성이 모두 성공하면 입력 파일을 지웁니다.
+//
+// 병합은 TFileMerger의 fast cloning을 사용하므로 basket을 압축 해제하지 않고 그대로 복사합니다.
+
+#include "Compression.h"
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// '*' 또는 '?'가 들어간 입력은 해당 디렉토리에서 패턴에 맞는 파일 목록으로 바꿉니다.
+std::vector<std::string> ExpandInputs(const std::vector<std::string>& patterns)
+{
+  std::vector<std::string> files;
+  for (const auto& pattern : patterns) {
+    if (pattern.find_first_of("*?") == std::string::npos) {
+      files.push_back(pattern);
+      continue;
+    }
+    const fs::path path(pattern);
+    const fs::path dir = path.has_parent_path() ? path.parent_path() : fs::path(".");
+    const std::string namePattern = path.filename().string();
+    std::vector<std::string> matched;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+      const std::string name = entry.path().filename().string();
+      if (fnmatch(namePattern.c_str(), name.c_str(), 0) == 0) matched.push_back(entry.path().string());
+    }
+    std::sort(matched.begin(), matched.end());
+    files.insert(files.end(), matched.begin(), matched.end());
+  }
+  return files;
+}
+
+// fast cloning이 basket을 그대로 복사할 수 있도록 첫 입력과 같은 압축 설정으로 출력 파일을 만듭니다.
+bool MergeFiles(const std::vector<std::string>& inputs, const std::string& output)
+{
+  int compression = ROOT::RCompressionSetting::EDefaults::kUseGeneralPurpose;
+  if (auto first = TFile::Open(inputs.front().c_str(), "READ")) {
+    compression = first->GetCompressionSettings();
+    delete first;
+  }
+
+  TFileMerger merger(false, false);
+  merger.SetFastMethod(true);
+  merger.SetPrintLevel(0);
+  if (!merger.OutputFile(output.c_str(), "RECREATE", compression)) return false;
+  for (const auto& input : inputs) {
+    if (!merger.AddFile(input.c_str(), false)) return false;
+  }
+  return merger.Merge();
+}
+
+// 이벤트마다 Hits / PMTHits 안에서의 시작 entry와 개수를 기록합니다.
+// 한 이벤트의 행들은 항상 한 워커가 연속으로 쓰므로 eventID branch만 읽어 구간을 찾을 수 있습니다.
+struct EventSpan {
+  Long64_t hitsFirst = -1;
+  Long64_t hitsCount = 0;
+  Long64_t pmtHitsFirst = -1;
+  Long64_t pmtHitsCount = 0;
+};
+
+void ScanTree(TTree* tree, std::map<int, EventSpan>& index, bool pmt)
+{
+  if (!tree) return;
+  int eventID = 0;
+  tree->SetBranchStatus("*", false);
+  tree->SetBranchStatus("eventID", true);
+  tree->SetBranchAddress("eventID", &eventID);
+
+  const Long64_t entries = tree->GetEntries();
+  for (Long64_t i = 0; i < entries; ++i) {
+    tree->GetEntry(i);
+    EventSpan& span = index[eventID];
+    Long64_t& first = pmt ? span.pmtHitsFirst : span.hitsFirst;
+    Long64_t& count = pmt ? span.pmtHitsCount : span.hitsCount;
+    if (first < 0) first = i;
+    ++count;
+  }
+  tree->ResetBranchAddresses();
+  tree->SetBranchStatus("*", true);
+}
+
+bool BuildEventIndex(const std::string& fileName)
+{
+  auto file = TFile::Open(fileName.c_str(), "UPDATE");
+  if (!file || file->IsZombie()) return false;
+
+  std::map<int, EventSpan> index;
+  ScanTree(file->Get<TTree>("Hits"), index, false);
+  ScanTree(file->Get<TTree>("PMTHits"), index, true);
+
+  int eventID = 0;
+  EventSpan span;
+  auto tree = new TTree("EventIndex", "Per-event entry ranges in Hits and PMTHits");
+  tree->Branch("eventID", &eventID, "eventID/I");
+  tree->Branch("hitsFirst", &span.hitsFirst, "hitsFirst/L");
+  tree->Branch("hitsCount", &span.hitsCount, "hitsCount/L");
+  tree->Branch("pmtHitsFirst", &span.pmtHitsFirst, "pmtHitsFirst/L");
+  tree->Branch("pmtHitsCount", &span.pmtHitsCount, "pmtHitsCount/L");
+  for (const auto& entry : index) {
+    eventID = entry.first;
+    span = entry.second;
+    tree->Fill();
+  }
+  tree->BuildIndex("eventID");
+  tree->Write("", TObject::kOverwrite);
+  file->Close();
+  delete file;
+
+  std::cout << "cpnr_merge: EventIndex with " << index.size() << " events written." << std::endl;
+  return true;
+}
+
+void Usage()
+{
+  std::cerr << "usage: cpnr_merge [-j jobs] [-d] -o output.root input.root ..." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  int jobs = 1;
+  bool deleteInputs = false;
+  std::string output;
+  std::vector<std::string> patterns;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-j" && i + 1 < argc) jobs = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "-o" && i + 1 < argc) output = argv[++i];
+    else if (arg == "-d") deleteInputs = true;
+    else if (!arg.empty() && arg[0] == '-') { Usage(); return 1; }
+    else patterns.push_back(arg);
+  }
+
+  const std::vector<std::string> inputs = ExpandInputs(patterns);
+  if (output.empty() || inputs.empty()) {
+    Usage();
+    return 1;
+  }
+
+  ROOT::EnableThreadSafety();
+
+  // 1단계: 입력을 jobs개의 묶음으로 나누어 동시에 병합합니다.
+  jobs = std::min<int>(jobs, static_cast<int>(inputs.size()));
+  std::vector<std::string> partials;
+  bool ok = true;
+  if (jobs <= 1) {
+    ok = MergeFiles(inputs, output);
+  } else {
+    std::vector<std::vector<std::string>> groups(jobs);
+    for (std::size_t i = 0; i < inputs.size(); ++i) groups[i % jobs].push_back(inputs[i]);
+
+    for (int g = 0; g < jobs; ++g) partials.push_back(output + ".part" + std::to_string(g));
+
+    std::vector<char> results(jobs, 0);
+    std::vector<std::thread> threads;
+    for (int g = 0; g < jobs; ++g) {
+      threads.emplace_back([&, g]() { results[g] = MergeFiles(groups[g], partials[g]); });
+    }
+    for (auto& thread : threads) thread.join();
+    ok = std::all_of(results.begin(), results.end(), [](char r) { return r != 0; });
+
+    // 2단계: 부분 결과를 하나로 합칩니다.
+    if (ok) ok = MergeFiles(partials, output);
+    for (const auto& partial : partials) std::remove(partial.c_str());
+  }
+
+  if (!ok) {
+    std::cerr << "cpnr_merge: merging failed, inputs are left untouched." << std::endl;
+    return 1;
+  }
+  std::cout << "cpnr_merge: " << inputs.size() << " files merged into " << output << std::endl;
+
+  if (!BuildEventIndex(output)) {
+    std::cerr << "cpnr_merge: could not build EventIndex in " << output << std::endl;
+    return 1;
+  }
+
+  if (deleteInputs) {
+    for (const auto& input : inputs) std::remove(input.c_str());
+  }
+  return 0;
+}
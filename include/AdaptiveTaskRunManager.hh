@@ -0,0 +1,62 @@
+#ifndef AdaptiveTaskRunManager_h
+#define AdaptiveTaskRunManager_h 1
+
+#include "G4TaskRunManager.hh"
+#include "globals.hh"
+
+#include <memory>
+
+class G4GenericMessenger;
+
+/**
+ * @class AdaptiveTaskRunManager
+ * @brief 측정한 이벤트당 비용으로 워커에게 넘기는 이벤트 묶음 크기를 정하는 tasking RunManager입니다.
+ *
+ * 이 시뮬레이션의 이벤트 비용은 크게 다릅니다 (빠져나가는 중성자는 싸고, 광학 광자가 많은 Gd 포획은 비쌉니다).
+ * 고정된 event modulo로 나눠 주면 런 끝에 큰 묶음을 받은 몇몇 스레드만 오래 남습니다.
+ * 여기서는 task 하나가 묶음 하나만 처리하고, task가 처음 이벤트를 요청할 때(SetUpNEvents) 다음 두 값 중
+ * 작은 쪽을 묶음 크기로 씁니다.
+ * - 남은 이벤트 / (tailFactor x 스레드 수): 런이 끝나갈수록 묶음이 작아집니다 (guided self-scheduling).
+ * - batchSeconds / 지금까지의 평균 이벤트 비용: 묶음 하나가 대략 batchSeconds 안에 끝나도록 합니다.
+ *
+ * G4TaskRunManager는 task 수와 task당 이벤트 루프 길이(numberOfEventsPerTask)를 런 시작 때 정하므로
+ * 이 값들은 바꾸지 않습니다. 대신
+ * - 묶음은 요청한 task의 루프에 남은 횟수를 넘지 않아, 넘겨준 이벤트 ID는 모두 처리됩니다.
+ * - 묶음을 끝낸 task는 0을 돌려받아 끝나며, 남은 이벤트가 있으면 대신할 task를 하나 추가합니다.
+ *   마스터도 런을 끝내기 전에 남은 이벤트가 없는지 확인하고, 처리한 이벤트 수가 요청과 다르면 경고합니다.
+ *
+ * 묶음 크기는 이벤트에 시드를 나눠 주는 방식에 영향을 주지 않으므로, 이벤트별 시드(기본값)에서는 재현성이 유지됩니다.
+ * 이벤트 비용은 EventAction이 RecordEventCost()로 알려줍니다.
+ *
+ * 매크로 명령어 (/myApp/run/):
+ * - adaptiveBatching <bool> (기본값 true), batchSeconds <초> (기본값 2), tailFactor <값> (기본값 2), maxBatch <n>
+ */
+class AdaptiveTaskRunManager : public G4TaskRunManager
+{
+public:
+  AdaptiveTaskRunManager();
+  ~AdaptiveTaskRunManager() override;
+
+  void InitializeEventLoop(G4int n_event, const char* macroFile = nullptr, G4int n_select = -1) override;
+  G4int SetUpNEvents(G4Event* event, G4SeedsQueue* seedsQueue, G4bool reseedRequired = true) override;
+  void RunTermination() override;
+
+  // 워커 스레드에서 이벤트 하나를 끝낼 때마다 호출합니다 (RunManager 종류와 상관없이 안전합니다).
+  static void RecordEventCost(G4double seconds);
+
+private:
+  void DefineCommands();
+  G4int NextBatchSize() const;
+  G4int HandOut(G4Event* event, G4SeedsQueue* seedsQueue, G4bool reseedRequired, G4int nEvents);
+
+  G4bool fAdaptive;
+  G4double fBatchSeconds;
+  G4double fTailFactor;
+  G4int fMaxBatch;
+  G4int fNumberOfBatches;
+  G4int fRunGeneration; // task별 상태(스레드 로컬)를 런마다 비우기 위한 번호
+
+  std::unique_ptr<G4GenericMessenger> fMessenger;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef Checkpoint_h
+#define Checkpoint_h 1
+
+#include "globals.hh"
+
+#include <map>
+
+/**
+ * @class Checkpoint
+ * @brief 출력 파일에 안전하게 기록된 이벤트 ID의 집합과, 중단된 런을 재개하는 데 필요한 정보입니다.
+ *
+ * OutputWriter가 일정 이벤트마다 TTree를 AutoSave한 직전까지 기록한 이벤트를 <이름>_run<ID>.ckpt 텍스트 파일로 남기고,
+ * /myApp/checkpoint/resume으로 같은 매크로를 다시 실행하면 마스터 RunAction이 이를 읽어 Completed()로 등록합니다.
+ * PrimaryGeneratorAction과 EventAction은 Completed()에 든 이벤트를 건너뜁니다.
+ *
+ * 이벤트 ID는 [first, last] 구간의 모음으로 저장하므로, MT에서 순서가 섞여 끝나는 이벤트도 작게 표현됩니다.
+ *
+ * 한 매크로에서 /run/beamOn을 여러 번 해도 섞이지 않도록 파일 이름과 내용에 런 ID가 들어가며,
+ * 같은 ID의 런을 재개할 때만 씁니다.
+ *
+ * 파일 형식:
+ *   run <런 ID>
+ *   resumeCount <n>
+ *   output <마지막으로 쓰던 출력 파일>
+ *   events 0-1234 1240-1300 ...
+ */
+class Checkpoint
+{
+public:
+  Checkpoint();
+
+  void Insert(G4int eventID) { InsertRange(eventID, eventID); }
+  void InsertRange(G4int first, G4int last);
+  void Merge(const Checkpoint& other);
+  G4bool Contains(G4int eventID) const;
+  G4long GetNumberOfEvents() const;
+  G4bool IsEmpty() const { return fRanges.empty(); }
+
+  void SetOutputFile(const G4String& fileName) { fOutputFile = fileName; }
+  const G4String& GetOutputFile() const { return fOutputFile; }
+  // 이 체크포인트가 기록한 런의 ID
+  void SetRunID(G4int runID) { fRunID = runID; }
+  G4int GetRunID() const { return fRunID; }
+  // 이 런이 몇 번째 재개인지 (처음 실행한 런은 0)
+  void SetResumeCount(G4int count) { fResumeCount = count; }
+  G4int GetResumeCount() const { return fResumeCount; }
+
+  // 임시 파일에 쓴 뒤 이름을 바꾸므로, 쓰는 도중에 죽어도 이전 체크포인트가 남습니다.
+  G4bool Save(const G4String& fileName) const;
+  // 읽은 내용을 이 객체에 합칩니다.
+  G4bool Load(const G4String& fileName);
+
+  // 이번 런에서 건너뛸(이미 끝난) 이벤트. 마스터가 런 시작 전에 설정하고, 런 동안에는 모든 스레드가 읽기만 합니다.
+  static const Checkpoint& Completed();
+  static void SetCompleted(const Checkpoint& checkpoint);
+
+private:
+  std::map<G4int, G4int> fRanges; // first -> last. 구간끼리는 겹치거나 맞닿지 않습니다.
+  G4String fOutputFile;
+  G4int fRunID;
+  G4int fResumeCount;
+};
+
+#endif
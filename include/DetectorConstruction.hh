@@ -5,11 +5,18 @@
 #include "globals.hh"
 #include "G4ThreeVector.hh"
 #include "G4SystemOfUnits.hh"
+#include "SegmentRayTracer.hh"
+#include "PMTOpticalResponse.hh"
+
+#include <map>
+#include <memory>
 
 class G4OpticalSurface;
 class G4VPhysicalVolume;
 class G4LogicalVolume;
 class G4Material;
+class G4Region;
+class G4GenericMessenger;
 
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -23,6 +30,26 @@ private:
     void DefineMaterials();
     G4LogicalVolume* ConstructSegment();
     G4LogicalVolume* ConstructPMT();
+    SegmentRayTracer::Config MakeSegmentOpticsConfig() const;
+    PMTOpticalResponse::Parameters MakePMTOpticsParameters() const;
+
+    // 영역(G4Region)별 컷과 사용자 제한 (/myApp/region/)
+    void DefineRegions(G4LogicalVolume* logicSegment, G4LogicalVolume* logicPMT);
+    void DefineCommands();
+    G4Region* FindRegion(const G4String& name) const;
+    G4bool ParseRegionQuantity(const G4String& args, G4String& regionName, G4double& value) const;
+    void SetRegionCut(const G4String& args);
+    void SetRegionMaxTime(const G4String& args);
+    void SetRegionMinEkine(const G4String& args);
+    void ApplyRegionLimits(const G4String& regionName);
+    void ListRegions();
+
+    struct RegionLimits {
+        G4double maxTime = DBL_MAX;
+        G4double minEkine = 0.;
+    };
+    std::map<G4String, RegionLimits> fRegionLimits;
+    std::unique_ptr<G4GenericMessenger> fRegionMessenger;
 
     // 물질 및 광학 표면 포인터
     G4Material* fWorldMaterial;
@@ -56,6 +83,7 @@ public:
     static constexpr G4double kSegmentLength = 200.0 * cm;
     static constexpr G4double kSegmentWidth  = 20.0 * cm;
     static constexpr G4double kSegmentHeight = 20.0 * cm;
+    static constexpr G4double kSegmentGap = 5.0 * cm; // 이웃한 세그먼트 사이의 간격
     
     static constexpr G4double kOuterPmmaThickness = 3.0 * cm;
     static constexpr G4double kInnerContainerWidth  = 12.0 * cm;
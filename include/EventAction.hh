@@ -2,14 +2,26 @@
 #define EventAction_h 1
 
 #include "G4UserEventAction.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
+#include "EventRecord.hh"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+class SlowEventMonitor;
+class TriggerFilter;
 
 /**
  * @class EventAction
  * @brief 각 이벤트(Event)의 시작과 끝에서 필요한 작업을 수행하는 클래스입니다.
  *
- * 이벤트가 끝날 때마다 LSHitsCollection과 PMTHitsCollection을 분석하여
- * 정의된 모든 TTree에 데이터를 기록하는 핵심적인 역할을 합니다.
+ * 이벤트가 끝날 때마다 LSHitsCollection과 PMTHitsCollection을 EventRecord로 모아
+ * OutputWriter의 쓰기 스레드에 넘기는 역할을 합니다. 이때 이벤트 요약(Events TTree)도 함께 계산하며,
+ * 중성자 포획 정보는 이벤트 도중 SteppingAction이 AddNeutronCapture()로 알려줍니다.
+ * 요약을 먼저 계산해 TriggerFilter에 넘기고, 통과한 이벤트만 EventRecord로 옮깁니다.
+ * 이벤트 CPU 시간은 SlowEventMonitor가 재며, 느린 이벤트를 재생용으로 기록합니다.
  */
 class EventAction : public G4UserEventAction
 {
@@ -17,7 +29,24 @@ public:
   EventAction();
   virtual ~EventAction();
 
+  virtual void BeginOfEventAction(const G4Event*) override;
   virtual void EndOfEventAction(const G4Event*) override;
+
+  // 중성자 포획 한 번을 기록합니다 (요약에는 첫 포획의 정보가 남습니다).
+  void AddNeutronCapture(const G4ThreeVector& position, G4double time, G4int targetZ, G4int targetA,
+                         G4int nGammas, G4double gammaEnergy, G4double weight);
+
+  SlowEventMonitor* GetSlowEventMonitor() const { return fSlowEvents.get(); }
+
+private:
+  EventSummaryRecord fSummary;
+  std::unique_ptr<TriggerFilter> fTrigger;
+  std::unique_ptr<SlowEventMonitor> fSlowEvents;
+  std::vector<G4int> fChannelPE;      // PMT 채널(segmentID * 2 + pmtID)별 광전자 수 (이벤트마다 재사용)
+  std::vector<G4double> fSegmentEdep; // 세그먼트 copyNo별 에너지 증착 합 [MeV]
+  G4int fLSHitsCollectionID;
+  G4int fPMTHitsCollectionID;
+  std::chrono::steady_clock::time_point fStartTime; // 이벤트 비용 측정용 (AdaptiveTaskRunManager)
 };
 
 #endif
@@ -0,0 +1,65 @@
+#ifndef EventRecord_h
+#define EventRecord_h 1
+
+#include "globals.hh"
+
+#include <string>
+#include <vector>
+
+/**
+ * @file EventRecord.hh
+ * @brief 한 이벤트의 출력 데이터를 담는 평범한 구조체들입니다.
+ *
+ * EventAction이 워커 스레드에서 HitsCollection을 한 번 훑어 만들고, OutputWriter의 쓰기 스레드로
+ * 통째로 넘깁니다. Geant4 객체를 참조하지 않으므로 이벤트가 끝난 뒤에도 안전하게 사용할 수 있습니다.
+ * 모든 값은 이미 출력 단위(mm, ns, MeV)로 변환되어 있습니다.
+ */
+
+struct LSHitRecord {
+  G4int trackID = 0;
+  G4int parentID = 0;
+  std::string particleName;
+  std::string processName;
+  std::string volumeName;
+  G4double x = 0., y = 0., z = 0.;
+  G4double time = 0.;
+  G4double kineticEnergy = 0.;
+  G4double energyDeposit = 0.;
+  G4int pdgID = 0;
+  G4double px = 0., py = 0., pz = 0.;
+  G4double energy = 0.;
+  G4double weight = 1.;
+};
+
+struct PMTHitRecord {
+  G4int segmentID = 0;
+  G4int pmtID = 0;
+  G4double time = 0.;
+};
+
+// 이벤트 하나의 요약 (Events TTree의 한 행)
+struct EventSummaryRecord {
+  G4double edepTotal = 0.;         // LS 전체 에너지 증착 [MeV]
+  G4double edepGdLS = 0.;          // Gd-LS(LogicLS_inner) 에너지 증착 [MeV]
+  G4double edepLS = 0.;            // LS(LogicLS_outer) 에너지 증착 [MeV]
+  G4int nCaptures = 0;             // 중성자 포획 횟수 (아래 값들은 첫 포획 기준)
+  G4double captureX = 0., captureY = 0., captureZ = 0.; // 포획 위치 [mm]
+  G4double captureTime = -1.;      // 포획 시각 [ns] (포획이 없으면 -1)
+  G4int captureTargetZ = 0;        // 포획 표적 핵의 Z, A
+  G4int captureTargetA = 0;
+  G4int captureGammaMultiplicity = 0; // 포획에서 나온 감마 수 (ANNRI-Gd cascade 다중도)
+  G4double captureGammaEnergy = 0.;   // 포획 감마 에너지 합 [MeV]
+  G4double captureWeight = 1.;        // 포획 산물의 biasing 가중치
+  G4int nPE = 0;                   // 검출된 광전자 수 (모든 PMT)
+  G4int nPMTsHit = 0;              // 광전자가 하나 이상인 PMT 수
+};
+
+struct EventRecord {
+  G4int eventID = 0;
+  G4bool accepted = true; // false: 트리거에 거절된 이벤트. 기록하지 않고 체크포인트의 완료 목록에만 넣습니다.
+  std::vector<LSHitRecord> lsHits;
+  std::vector<PMTHitRecord> pmtHits;
+  EventSummaryRecord summary;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef EventSeeder_h
+#define EventSeeder_h 1
+
+#include "globals.hh"
+
+#include <memory>
+
+class G4Event;
+class G4GenericMessenger;
+
+/**
+ * @class EventSeeder
+ * @brief 각 이벤트의 난수 엔진 상태를 (마스터 시드, 런 ID, 이벤트 ID)에서 결정적으로 만드는 클래스입니다.
+ *
+ * 기본 MT RunManager에서는 이벤트의 난수열이 시드 큐에서 꺼낸 순서에 따라 정해지므로,
+ * 특정 이벤트 하나(이상한 Gd 포획, 유난히 느린 이벤트 등)만 따로 다시 돌려 볼 수 없습니다.
+ * 이벤트 시드 모드를 켜면 PrimaryGeneratorAction이 1차 입자를 만들기 직전에 Reseed()를 호출해,
+ * 스레드 배치, event modulo, 순차/MT/fork/cpnr_driver 분할과 상관없이 같은 이벤트는 같은 난수열을 씁니다.
+ *
+ * 마스터 시드는 생성 시점(-s 적용 직후)의 G4Random::getTheSeed()이며, 명령어로 바꿀 수 있습니다.
+ * main에서 하나만 만들며, 상태는 모든 스레드가 읽는 전역 값입니다.
+ *
+ * 매크로 명령어 (/myApp/random/):
+ * - eventSeeding <bool> : 이벤트별 시드 on/off (기본값 false)
+ * - masterSeed <n> : 이벤트 시드를 만드는 마스터 시드
+ * - replayEvent <eventID> [runID] : 그 이벤트 하나를 tracking verbose 1로 다시 만들어 <fileName>_replay<eventID>에 씁니다.
+ *   원래 런도 이벤트 시드 모드였어야 하며, 마스터 시드와 설정이 같아야 합니다.
+ * - replayState <file> : SlowEventMonitor가 남긴 엔진 상태(.rndm)에서 이벤트 하나를 다시 만들어 <file 이름>_replay에 씁니다.
+ *   시드 큐를 쓰는 MT RunManager에서는 상태를 되살릴 수 없으므로 순차 모드(-r serial)에서만 동작합니다.
+ */
+class EventSeeder
+{
+public:
+  EventSeeder();
+  ~EventSeeder();
+
+  // 이벤트 시드 모드일 때 이 스레드의 엔진을 이 이벤트의 상태로 다시 시드합니다.
+  static void Reseed(const G4Event* event);
+  static G4bool IsEnabled();
+
+private:
+  void DefineCommands();
+  void SetEnabled(G4bool enabled);
+  void SetMasterSeed(G4long seed);
+  void ReplayEvent(const G4String& args);
+  void ReplayState(const G4String& file);
+
+  std::unique_ptr<G4GenericMessenger> fMessenger;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef ForkRunManager_h
+#define ForkRunManager_h 1
+
+#include "G4RunManager.hh"
+#include "globals.hh"
+
+/**
+ * @class ForkRunManager
+ * @brief 한 프로세스에서 모두 초기화한 뒤 fork()로 N개의 자식 프로세스가 이벤트를 나눠 실행하는 RunManager입니다.
+ *
+ * Geant4 MT도 기하구조는 공유하지만, 워커마다 GdNeutronHPCapture(ANNRI-Gd 테이블), HP final-state 캐시,
+ * 출력 버퍼를 따로 만들고, 공유 데이터에 대한 경합 때문에 코어 수만큼 빨라지지 않는 노드가 있습니다.
+ * 이 모드에서는 부모가 순차 모드로 기하구조, 물리 리스트, 물리 테이블, HP 데이터, ANNRI-Gd 테이블을 모두 만든 뒤
+ * fork()합니다. 자식들은 이 데이터를 copy-on-write 페이지로 공유하며, 쓰기가 일어난 페이지만 복사됩니다.
+ *
+ * - 자식 k는 겹치지 않는 이벤트 구간 [k*N/n, (k+1)*N/n)을 실행하고, 이벤트 ID도 그 구간의 값을 씁니다.
+ * - 시드는 부모의 난수 엔진에서 자식마다 뽑으므로 (-s가 같으면) 실행할 때마다 같습니다.
+ * - 자식은 자신의 출력 파일 <이름>_p<k>.root 를 씁니다. cpnr_merge로 합칠 수 있습니다.
+ *
+ * 첫 이벤트 ID를 정할 수 있으므로 fork 없이 순차 모드로 돌리는 독립 작업(cpnr_driver)에도 씁니다.
+ *
+ * fork 모드에서는 SetSetupOnly(true)로 RunForked() 전까지의 /run/beamOn을 무시하므로, 매크로는 설정만 담아야 합니다
+ * (run.mac처럼 /run/beamOn이 있으면 경고하고 건너뜁니다). 자식은 런이 중단되었거나 이벤트를 모두 처리하지 못했거나
+ * 출력 파일을 열지 못하면 0이 아닌 종료 코드를 돌려주므로, 부모가 세는 실패 수에 반영됩니다.
+ *
+ * fork() 당시 부모에는 스레드가 없어야 하므로 순차 RunManager를 기반으로 하고, 출력 파일은 자식이 런을 시작할 때 엽니다.
+ */
+class ForkRunManager : public G4RunManager
+{
+public:
+  ForkRunManager();
+  ~ForkRunManager() override;
+
+  // 부모에서 호출합니다. 자식 프로세스 안에서는 자신의 몫을 실행한 뒤, 부모에서는 모든 자식이 끝난 뒤 반환하며
+  // 프로세스의 종료 코드를 돌려줍니다.
+  G4int RunForked(G4int nProcesses, G4int nEvents);
+
+  G4bool IsChild() const { return fChildIndex >= 0; }
+
+  // true이면 RunForked()가 시작될 때까지 BeamOn()을 경고와 함께 무시합니다 (매크로의 /run/beamOn 방지).
+  void SetSetupOnly(G4bool setupOnly) { fSetupOnly = setupOnly; }
+
+  void BeamOn(G4int n_event, const char* macroFile = nullptr, G4int n_select = -1) override;
+
+  // 이 프로세스(fork 모드에서는 첫 자식)가 실행할 첫 이벤트의 ID
+  void SetFirstEventID(G4int eventID) { fFirstEventID = eventID; fEventOffset = eventID; }
+
+protected:
+  G4Event* GenerateEvent(G4int i_event) override;
+
+private:
+  G4int fChildIndex;
+  G4int fFirstEventID;
+  G4int fEventOffset;
+  G4bool fSetupOnly;
+};
+
+#endif
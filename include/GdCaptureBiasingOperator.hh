@@ -0,0 +1,54 @@
+#ifndef GdCaptureBiasingOperator_h
+#define GdCaptureBiasingOperator_h 1
+
+#include "G4VBiasingOperator.hh"
+#include <map>
+#include <memory>
+
+class G4BOptnChangeCrossSection;
+class G4GenericMessenger;
+class G4ParticleDefinition;
+
+/**
+ * @class GdCaptureBiasingOperator
+ * @brief Gd-LS(LogicLS_inner) 안에서 중성자 포획(nCapture) 단면적을 키우는 biasing operator 입니다.
+ *
+ * MyShieldingPhysList가 G4GenericBiasingPhysics로 중성자의 nCapture를 G4BiasingProcessInterface로
+ * 감싸 두고, 이 operator가 붙은 볼륨에서만 G4BOptnChangeCrossSection으로 단면적을 factor 배로 바꿉니다.
+ * 상호작용이 일어나면 포획 감마(와 그 자손)는 1/factor에 가까운 가중치를, 살아남은 중성자는
+ * 생존 확률 비에 해당하는 가중치를 가지게 되며, 이 가중치는 LSHit과 Hits ntuple의 weight에 기록됩니다.
+ *
+ * 매크로 명령어:
+ * - /myApp/bias/gdCapture/enable : biasing on/off (기본값 false)
+ * - /myApp/bias/gdCapture/factor : 포획 단면적 배율 (기본값 10)
+ */
+class GdCaptureBiasingOperator : public G4VBiasingOperator {
+public:
+    GdCaptureBiasingOperator();
+    ~GdCaptureBiasingOperator() override;
+
+    void StartRun() override;
+
+private:
+    G4VBiasingOperation* ProposeOccurenceBiasingOperation(const G4Track* track,
+                                                          const G4BiasingProcessInterface* callingProcess) override;
+    G4VBiasingOperation* ProposeFinalStateBiasingOperation(const G4Track*, const G4BiasingProcessInterface*) override
+    { return nullptr; }
+    G4VBiasingOperation* ProposeNonPhysicsBiasingOperation(const G4Track*, const G4BiasingProcessInterface*) override
+    { return nullptr; }
+
+    void OperationApplied(const G4BiasingProcessInterface* callingProcess, G4BiasingAppliedCase biasingCase,
+                          G4VBiasingOperation* occurenceOperationApplied, G4double weightForOccurenceInteraction,
+                          G4VBiasingOperation* finalStateOperationApplied,
+                          const G4VParticleChange* particleChangeProduced) override;
+
+    void DefineCommands();
+
+    std::unique_ptr<G4GenericMessenger> fMessenger;
+    std::map<const G4BiasingProcessInterface*, std::unique_ptr<G4BOptnChangeCrossSection>> fOperations;
+    const G4ParticleDefinition* fNeutron;
+    G4bool fEnabled;
+    G4double fFactor;
+};
+
+#endif
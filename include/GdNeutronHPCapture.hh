@@ -16,6 +16,8 @@ public:
     GdNeutronHPCapture();
     ~GdNeutronHPCapture() override;
 
+    void BuildPhysicsTable(const G4ParticleDefinition& particle) override;
+
     // 부모 클래스의 ApplyYourself를 재정의(override)
     G4HadFinalState* ApplyYourself(const G4HadProjectile& aTrack, G4Nucleus& aTargetNucleus) override;
     
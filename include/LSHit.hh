@@ -59,6 +59,14 @@ public:
   void SetEnergy(G4double e) { fEnergy = e; }
   G4double GetEnergy() const { return fEnergy; }
 
+  // --- 이벤트 biasing 가중치 (biasing이 꺼져 있으면 1) ---
+  void SetWeight(G4double w) { fWeight = w; }
+  G4double GetWeight() const { return fWeight; }
+
+  // --- 히트가 속한 세그먼트의 copyNo ---
+  void SetSegmentID(G4int id) { fSegmentID = id; }
+  G4int GetSegmentID() const { return fSegmentID; }
+
 
 private:
   G4int         fTrackID;
@@ -77,6 +85,8 @@ private:
   G4double      fPy;
   G4double      fPz;
   G4double      fEnergy;
+  G4double      fWeight;
+  G4int         fSegmentID;
 };
 
 typedef G4THitsCollection<LSHit> LSHitsCollection;
@@ -0,0 +1,61 @@
+#ifndef MPSCQueue_h
+#define MPSCQueue_h 1
+
+#include <atomic>
+#include <utility>
+
+/**
+ * @class MPSCQueue
+ * @brief 여러 생산자(워커 스레드)와 하나의 소비자(쓰기 스레드)를 위한 lock-free 큐입니다.
+ *
+ * D. Vyukov의 intrusive MPSC 큐 구조를 따릅니다. Push()는 원자적 exchange 한 번으로 끝나므로
+ * 워커 스레드는 기다리지 않고 바로 다음 이벤트로 돌아갑니다. Pop()은 소비자 스레드 하나에서만 호출해야 합니다.
+ * 생산자가 노드를 연결하는 도중에는 Pop()이 잠시 비어 있다고 답할 수 있으며, 이는 다음 호출에서 해소됩니다.
+ */
+template <typename T>
+class MPSCQueue
+{
+public:
+  MPSCQueue() : fHead(new Node()), fTail(fHead.load(std::memory_order_relaxed)) {}
+
+  ~MPSCQueue()
+  {
+    T discarded;
+    while (Pop(discarded)) {}
+    delete fTail;
+  }
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  void Push(T value)
+  {
+    Node* node = new Node(std::move(value));
+    Node* prev = fHead.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  bool Pop(T& value)
+  {
+    Node* tail = fTail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (!next) return false;
+    value = std::move(next->value);
+    fTail = next;
+    delete tail;
+    return true;
+  }
+
+private:
+  struct Node {
+    Node() = default;
+    explicit Node(T&& v) : value(std::move(v)) {}
+    std::atomic<Node*> next{nullptr};
+    T value{};
+  };
+
+  std::atomic<Node*> fHead; // 생산자들이 붙이는 쪽
+  Node* fTail;              // 소비자가 꺼내는 쪽 (직전에 꺼낸 노드가 stub 역할)
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef OnlineHistograms_h
+#define OnlineHistograms_h 1
+
+#include "globals.hh"
+#include "EventRecord.hh"
+
+#include <vector>
+
+/**
+ * @class OnlineHistograms
+ * @brief 런 도중 G4AnalysisManager H1/H2로 채우는 표준 히스토그램 묶음입니다.
+ *
+ * analysis.cc / analysis_kinetic.cc처럼 Hits TTree를 다시 훑지 않아도 기본 분포를 볼 수 있습니다.
+ * 각 워커가 자신의 G4AnalysisManager에 채우고, 런이 끝나면 마스터가 합쳐 <fileName>_histos.root에 씁니다.
+ * Hits / PMTHits / Events는 OutputWriter가 따로 쓰므로 G4AnalysisManager는 히스토그램만 다룹니다.
+ * 트리거(TriggerFilter)를 통과한 이벤트만 채우므로 출력 파일의 내용과 일치합니다 (이벤트 CPU 시간만 모든 이벤트를 채웁니다).
+ *
+ * 비닝은 Geant4 기본 명령어로 바꿀 수 있습니다. 예: /analysis/h1/set 0 1200 0 12
+ *
+ * | ID     | 내용                                            | 가중치          |
+ * |--------|-------------------------------------------------|-----------------|
+ * | H1 0   | 이벤트당 LS 에너지 증착 합 [MeV] (h_total_edep)  | 없음            |
+ * | H1 1   | 에너지를 증착한 입자의 운동 에너지 [MeV] (h_kinetic) | Hit 가중치    |
+ * | H1 2   | 첫 중성자 포획 시각 [us]                         | 포획 가중치     |
+ * | H1 3   | 포획 감마 에너지 합 [MeV]                         | 포획 가중치     |
+ * | H1 4   | 이벤트당 광전자 수                               | 없음            |
+ * | H1 5   | 이벤트 CPU 시간 [s], 로그 비닝 (h_event_cpu_time) | 없음            |
+ * | H2 0   | 세그먼트 ID vs 세그먼트별 에너지 증착 [MeV]       | 없음            |
+ */
+class OnlineHistograms
+{
+public:
+  enum H1 { kEdepTotal = 0, kHitKineticEnergy, kCaptureTime, kCaptureGammaEnergy, kNPE, kEventCPUTime };
+  enum H2 { kSegmentEdep = 0 };
+
+  // 모든 스레드의 RunAction 생성자에서 한 번 호출합니다.
+  static void Book();
+
+  // 히스토그램 파일이 열려 있을 때만 채웁니다. 파일은 RunAction이 엽니다.
+  static G4bool IsActive();
+  static void FillHit(G4double kineticEnergy, G4double weight);
+  // segmentEdep: 세그먼트 copyNo별 에너지 증착 합 [MeV]
+  static void FillEvent(const EventSummaryRecord& summary, const std::vector<G4double>& segmentEdep);
+  // 트리거 판정 전에 모든 이벤트에 대해 호출합니다 (SlowEventMonitor가 잰 시간).
+  static void FillEventTime(G4double cpuSeconds);
+};
+
+#endif
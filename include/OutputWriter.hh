@@ -0,0 +1,169 @@
+#ifndef OutputWriter_h
+#define OutputWriter_h 1
+
+#include "globals.hh"
+#include "Checkpoint.hh"
+#include "EventRecord.hh"
+#include "MPSCQueue.hh"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TFile;
+class TTree;
+
+// Hits / PMTHits 컬럼 하나 (이름, 저장 타입, 레코드에서 값을 꺼내는 방법). 구현은 OutputWriter.cc에 있습니다.
+template <typename Record>
+class OutputColumn
+{
+public:
+  virtual ~OutputColumn() = default;
+  virtual void Book(TTree* tree, G4bool perEvent) = 0;
+  virtual void Set(const Record& record) = 0;    // 행 스키마: 다음 Fill()에 쓸 값
+  virtual void Append(const Record& record) = 0; // vector 스키마: 이번 이벤트의 vector에 추가
+  virtual void Clear() = 0;
+};
+
+/**
+ * @class OutputWriter
+ * @brief 출력 ROOT 파일을 단독으로 소유하는 비동기 쓰기 스레드입니다.
+ *
+ * - 워커 스레드는 EventAction에서 완성된 EventRecord를 Submit()으로 MPSCQueue에 넣고 곧바로 수송으로 돌아갑니다.
+ * - 쓰기 스레드는 큐에 쌓인 레코드를 묶음으로 꺼내 Hits / PMTHits / Events TTree를 채웁니다.
+ *   ROOT 객체는 이 스레드만 만지므로 G4AnalysisManager의 ntuple 병합 과정이 필요 없습니다.
+ * - Open()/Close()는 마스터 RunAction이 런의 시작과 끝에서 호출합니다. Close()는 큐를 모두 비운 뒤 파일을 닫습니다.
+ *
+ * 공유 출력(기본값)은 프로세스 전체에 하나뿐인 Instance()가 담당합니다.
+ * 스레드별 출력 모드(/myApp/output/mode perThread)에서는 워커 RunAction이 동기식 OutputWriter를 하나씩 만들어
+ * SetThreadWriter()로 등록하며, 이 경우 레코드는 큐를 거치지 않고 워커 스레드에서 바로 자신의 파일에 기록됩니다.
+ * 여러 스레드가 ROOT를 쓰므로 main이 스레드를 만들기 전에 ROOT::EnableThreadSafety()를 한 번 호출해야 합니다.
+ *
+ * Hits / PMTHits의 스키마는 두 가지입니다 (/myApp/output/layout).
+ * - kRowPerHit(기본값): Hit 하나가 한 행이며 eventID가 행마다 반복됩니다.
+ * - kVectorPerEvent: 이벤트 하나가 한 행이며 각 컬럼은 std::vector입니다. 병합된 MT 출력에서도 이벤트가
+ *   항상 한 entry로 묶여 있고, Hits / PMTHits / Events의 entry 번호가 서로 일치합니다.
+ *
+ * 어떤 컬럼을 어떤 타입으로 쓸지는 프로파일이 정합니다 (/myApp/output/profile).
+ * - kFull(기본값): 기존 스키마 그대로 (실수는 double, 문자열 컬럼 포함)
+ * - kPhysics: 문자열 대신 volumeID(UChar_t), 실수는 float, 중복 정보인 energy_MeV 제외
+ * - kMinimal: eventID, pdgID, volumeID, 위치, 시간, 에너지 증착, 가중치만 (float)
+ * PMTHits는 kFull이 아니면 segmentID/pmtID를 UShort_t/UChar_t로, time_ns를 float로 씁니다.
+ * 이벤트당 한 행인 Events는 프로파일과 상관없이 그대로입니다.
+ *
+ * 압축 알고리즘과 수준, TTree별 basket 크기와 auto-flush(클러스터) 크기는 Storage로 정합니다.
+ * Benchmark()는 현재 스키마와 설정으로 합성 이벤트를 써 보고 쓰기 처리량과 압축률을 보고합니다.
+ *
+ * SetRollover()로 이벤트 수 또는 파일 크기 한도를 주면 <이름>_0000.root, <이름>_0001.root, ...로 나눠 씁니다.
+ * 쓰는 중인 파일은 <이름>_NNNN.root.part이고, 한도에 닿아 닫히는 순간 최종 이름으로 바뀌므로
+ * 후속 작업은 런이 끝나기 전에도 완성된 파일부터 처리할 수 있습니다.
+ *
+ * SetCheckpoint()로 체크포인트를 켜면 interval개 이벤트마다 모든 TTree를 AutoSave("SaveSelf")해 파일을
+ * 복구 가능한 상태로 만들고, 그때까지 기록한 이벤트 ID를 Checkpoint 파일에 남깁니다. 나눠 쓰는 파일이
+ * 닫힐 때도 체크포인트를 갱신하므로, 닫힌 파일의 이벤트가 재개할 때 다시 만들어지지 않습니다.
+ */
+class OutputWriter
+{
+public:
+  enum class Layout { kRowPerHit, kVectorPerEvent };
+  enum class Profile { kFull, kPhysics, kMinimal };
+
+  // ROOT 파일의 저장 설정. TTree 이름 대신 "all"을 쓰면 이름으로 따로 지정하지 않은 모든 TTree에 적용됩니다.
+  struct Storage {
+    G4String compression = "default";     // default(ROOT 기본값), none, zlib, lz4, zstd, lzma
+    G4int compressionLevel = -1;          // 1-9, -1이면 알고리즘별 기본 수준
+    std::map<G4String, G4int> basketSize; // TTree 이름 -> branch당 basket 크기 [bytes]
+    std::map<G4String, G4long> autoFlush; // TTree 이름 -> 클러스터 크기 (>0: entry 수, <0: 바이트 수)
+  };
+
+  // 공유 출력 파일을 담당하는 비동기 writer
+  static OutputWriter* Instance();
+  // 현재 스레드가 레코드를 넘길 writer (스레드별 writer가 등록되어 있으면 그것, 아니면 Instance())
+  static OutputWriter* ForThisThread();
+  static void SetThreadWriter(OutputWriter* writer);
+  // 프로세스의 모든 writer가 지금까지 디스크에 쓴 바이트 수 (ProgressMonitor용)
+  static G4long GetBytesWritten();
+
+  explicit OutputWriter(G4bool asynchronous);
+  ~OutputWriter();
+
+  // layout, profile, storage는 다음 Open()부터 적용됩니다.
+  void SetLayout(Layout layout) { fLayout = layout; }
+  void SetProfile(Profile profile) { fProfile = profile; }
+  void SetStorage(const Storage& storage) { fStorage = storage; }
+  // maxEvents / maxBytes 중 먼저 닿는 한도에서 다음 파일로 넘어갑니다. 둘 다 0이면 파일 하나에 씁니다.
+  void SetRollover(G4long maxEvents, G4long maxBytes) { fRollEvents = maxEvents; fRollBytes = maxBytes; }
+  // interval이 0이면 체크포인트를 쓰지 않습니다. initial은 재개할 때 이미 끝난 이벤트입니다.
+  void SetCheckpoint(const G4String& fileName, G4long interval, const Checkpoint& initial);
+  G4bool IsCheckpointing() const { return fCheckpointInterval > 0; }
+  void Open(const G4String& fileName);
+  void Close();
+  G4bool IsOpen() const { return fOpen.load(std::memory_order_acquire); }
+  // 마지막 Open() 이후 출력 파일(나눠 쓸 때의 다음 파일 포함)을 열지 못한 적이 있으면 true
+  G4bool HasOpenFailed() const { return fOpenFailed.load(std::memory_order_acquire); }
+
+  // 워커 스레드에서 호출합니다. 파일이 열려 있지 않으면 레코드를 버리고 false를 돌려줍니다.
+  G4bool Submit(std::unique_ptr<EventRecord> record);
+
+  // 동기식 writer에서만 호출합니다. 합성 이벤트 nEvents개를 fileName에 쓰고 결과를 출력한 뒤 파일을 지웁니다.
+  void Benchmark(const G4String& fileName, G4int nEvents);
+
+private:
+  template <typename Record>
+  using Columns = std::vector<std::unique_ptr<OutputColumn<Record>>>;
+
+  void Run();
+  std::size_t Drain(std::size_t maxRecords);
+  void Write(const EventRecord& record);
+  G4bool IsRolling() const;
+  G4String ChunkFileName() const;
+  G4bool OpenFile();
+  void CloseFile();
+  void RollOver();
+  void SaveCheckpoint(G4bool autoSave);
+  void BookTrees();
+  void ApplyStorage(TTree* tree) const;
+  G4int CompressionSettings() const;
+
+  const G4bool fAsynchronous;
+  Layout fLayout;
+  Profile fProfile;
+  Storage fStorage;
+  MPSCQueue<std::unique_ptr<EventRecord>> fQueue;
+  std::thread fThread;
+  std::atomic<G4bool> fOpen;
+  std::atomic<G4bool> fOpenFailed;
+  std::atomic<G4bool> fStopRequested;
+  std::atomic<std::size_t> fPending;   // 큐에 들어 있는 레코드 수 (역압 제어용)
+  std::size_t fMaxPending;             // 이보다 많이 밀리면 생산자가 잠시 양보합니다.
+  std::size_t fPeakPending;
+  std::size_t fEventsWritten;
+  G4String fFileName;                  // Open()에 넘긴 이름 (나눠 쓸 때는 번호를 붙이는 기준)
+  G4long fEventsInFile;
+  G4long fRollEvents;
+  G4long fRollBytes;
+  G4int fChunk;                        // 지금 쓰는 파일 번호
+  G4bool fRollPending;                 // 직전 파일을 닫았고, 다음 레코드에서 새 파일을 엽니다.
+  G4String fCheckpointFile;
+  G4long fCheckpointInterval;
+  G4long fEventsSinceCheckpoint;
+  Checkpoint fCheckpoint;              // 쓰기 스레드만 갱신합니다.
+  G4long fTotBytes;                    // 이번 Open() 이후 닫은 파일들의 압축 전/후 크기 합
+  G4long fZipBytes;
+  G4long fFileBytes;                   // 지금 쓰는 파일에서 GetBytesWritten()에 이미 반영한 바이트 수
+
+  // --- 쓰기 스레드 전용 ROOT 객체와 branch 버퍼 ---
+  TFile* fFile;
+  TTree* fHitsTree;
+  TTree* fPMTHitsTree;
+  TTree* fEventsTree;
+  G4int fEventID;
+  EventSummaryRecord fSummary;
+  Columns<LSHitRecord> fLSColumns;   // branch 버퍼를 각 컬럼이 소유합니다.
+  Columns<PMTHitRecord> fPMTColumns;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef PMTOpticalModel_h
+#define PMTOpticalModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "PMTOpticalResponse.hh"
+
+/**
+ * @class PMTOpticalModel
+ * @brief PMT 유리/진공 내부의 광학 광자 수송을 해석적 응답으로 대체하는 Fast Simulation 모델입니다.
+ *
+ * PMT 유리(LogicPmtGlass)를 envelope으로 하는 G4Region에 붙습니다. 평평한 입사창으로 들어오는
+ * 광자만 넘겨받아 PMTOpticalResponse로 검출 여부와 비행 시간을 정하고, 검출되면 PMTSD에
+ * PMTHit을 직접 추가합니다. 그 외의 광자(옆면 입사, 유리 안에서 생성된 광자 등)는 정상 추적을 계속합니다.
+ *
+ * - 모델의 on/off는 Geant4 기본 명령어인 /param/InActivateModel PMTOpticalModel 을 사용합니다.
+ */
+class PMTOpticalModel : public G4VFastSimulationModel
+{
+public:
+  PMTOpticalModel(const G4String& name, G4Region* envelope, G4double faceZ,
+                  const PMTOpticalResponse::Parameters& parameters);
+  ~PMTOpticalModel() override;
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+  G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+  void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+
+private:
+  PMTOpticalResponse fResponse;
+  G4double fFaceZ; // envelope 좌표계에서 입사창의 z 위치
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef PMTOpticalResponse_h
+#define PMTOpticalResponse_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4MaterialPropertyVector.hh"
+
+/**
+ * @class PMTOpticalResponse
+ * @brief PMT 입사창으로 들어온 광자의 검출 여부를 해석적으로 결정하는 클래스입니다.
+ *
+ * DetectorConstruction::ConstructPMT()의 진공 polycone은 유리와 같은 z 평면을 가지므로, windowRadius
+ * 안쪽의 입사창 면에는 유리가 없고 그리스가 진공과 직접 맞닿습니다. 광음극은 입사창에서 일정 깊이만큼
+ * 떨어진 목(neck) 위치의 원판입니다. 입사창과 광음극 사이의 진공 영역은 볼록하므로, 광자는
+ * 그리스→진공 경계의 Fresnel 투과 후 직선으로 광음극 평면까지 날아갑니다.
+ * 광음극 원판 안에 떨어지면 양자효율(EFFICIENCY)로 검출 여부를 정하고, 원뿔 벽에 닿는 광자는 잃은 것으로 봅니다.
+ *
+ * PMT 좌표계는 입사창 중심이 원점이고 +z가 광음극 쪽을 향하도록 잡습니다.
+ */
+class PMTOpticalResponse
+{
+public:
+  struct Parameters {
+    G4MaterialPropertyVector* greaseRindex = nullptr;      // 진공과 맞닿은 광학 그리스의 RINDEX
+    G4MaterialPropertyVector* quantumEfficiency = nullptr; // 광음극 양자효율
+    G4double windowRadius = 0.;                             // 진공과 맞닿은 입사창 영역의 반지름
+    G4double cathodeRadius = 0.;                            // 광음극 원판의 반지름
+    G4double cathodeDepth = 0.;                             // 입사창에서 광음극 표면까지의 거리
+  };
+
+  // 입사창에 닿은 광자 하나의 결과
+  enum class Outcome {
+    kReflected, // 전반사나 Fresnel 반사로 입사창 앞 매질로 되돌아감
+    kLost,      // 입사창 밖이나 광음극 원판 밖에 닿았거나, 양자효율에서 탈락함
+    kDetected   // 광전자가 만들어짐
+  };
+
+  explicit PMTOpticalResponse(const Parameters& parameters);
+  ~PMTOpticalResponse();
+
+  /**
+   * @param x, y       입사창 위의 위치 (PMT 축 기준)
+   * @param dir        입사창에 닿기 직전 매질에서의 방향 (dir.z() > 0 이 광음극 방향)
+   * @param nIncident  그 매질의 굴절률. 평행한 층(PMMA/그리스)에서는 n sinθ가 보존되므로
+   *                   진공 앞의 어느 층에서 넘겨도 진공 안의 방향은 같습니다.
+   * @param energy     광자 에너지
+   * @param flightTime [출력] 입사창에서 광음극까지의 비행 시간
+   * @return kReflected이면 호출한 쪽에서 광자를 반사시켜 계속 추적해야 합니다.
+   */
+  Outcome Detect(G4double x, G4double y, const G4ThreeVector& dir, G4double nIncident,
+                 G4double energy, G4double& flightTime) const;
+
+  // 그리스→진공 경계를 이미 지나 진공 안에 있는 광자용입니다 (dir은 진공 안의 방향).
+  // 굴절과 Fresnel 반사는 G4OpBoundaryProcess가 이미 처리했으므로 kReflected는 나오지 않습니다.
+  Outcome DetectInVacuum(G4double x, G4double y, const G4ThreeVector& dir,
+                         G4double energy, G4double& flightTime) const;
+
+  const Parameters& GetParameters() const { return fParameters; }
+
+  // 비편광 광자의 Fresnel 반사율 (전반사이면 1)
+  static G4double FresnelReflectance(G4double n1, G4double n2, G4double cosI);
+
+private:
+  // 진공 안의 방향 u(sinVac, cosVac)로 광음극 평면까지 날아가 양자효율을 적용합니다.
+  Outcome FlyToCathode(G4double x, G4double y, const G4ThreeVector& u, G4double sinVac, G4double cosVac,
+                       G4double energy, G4double& flightTime) const;
+
+  Parameters fParameters;
+};
+
+#endif
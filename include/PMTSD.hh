@@ -20,6 +20,9 @@ public:
   virtual void Initialize(G4HCofThisEvent* hce) override;
   virtual G4bool ProcessHits(G4Step* aStep, G4TouchableHistory* ROhist) override;
 
+  // Fast Simulation 모델처럼 스텝 없이 검출을 결정한 경우, 현재 이벤트의 컬렉션에 Hit를 직접 추가합니다.
+  void InsertHit(G4int segmentID, G4int pmtID, G4double time);
+
 private:
   PMTHitsCollection* fHitsCollection;
 };
@@ -0,0 +1,41 @@
+#ifndef PhysicsTableCache_h
+#define PhysicsTableCache_h 1
+
+#include "G4VStateDependent.hh"
+#include "globals.hh"
+
+/**
+ * @class PhysicsTableCache
+ * @brief 만든 물리 테이블을 캐시 디렉토리에 저장해 두고, 같은 구성의 다음 작업에서 다시 읽어오는 클래스입니다.
+ *
+ * 커널이 물리 테이블을 만들기 위해 G4State_Init로 들어가는 순간 현재 구성의 키를 계산합니다.
+ * 키는 Geant4 버전, 입자별 프로세스 목록, EM 파라미터, 물질, 영역별 컷의 해시입니다.
+ * - <캐시>/<키>/ 가 있으면 G4VUserPhysicsList::SetPhysicsTableRetrieved()로 테이블을 읽어옵니다.
+ * - 없으면 평소처럼 테이블을 만든 뒤 StorePhysicsTable()로 저장합니다. 임시 디렉토리에 쓴 다음 이름을 바꾸므로,
+ *   같은 캐시를 쓰는 작업이 동시에 여러 개 돌아도 반쯤 쓰인 캐시를 읽지 않습니다.
+ *
+ * Geant4의 테이블 저장은 단면적/에너지 손실 테이블을 가진 프로세스(EM 등)만 다룹니다.
+ * 중성자 HP 데이터(G4NDL)와 ANNRI-Gd 테이블은 여전히 매번 읽습니다.
+ *
+ * 마스터 스레드에서 runManager->Initialize() 전에 만들어야 합니다 (MT에서는 Initialize() 안에서 테이블을 만듭니다).
+ * G4StateManager에 등록되며 G4StateManager가 소멸할 때 함께 지워집니다.
+ */
+class PhysicsTableCache : public G4VStateDependent
+{
+public:
+    explicit PhysicsTableCache(const G4String& directory);
+    ~PhysicsTableCache() override;
+
+    G4bool Notify(G4ApplicationState requestedState) override;
+
+private:
+    G4String ComputeConfiguration() const;
+    void Store();
+
+    G4String fDirectory;
+    G4String fKey;           // 마지막으로 처리한 구성의 키
+    G4String fConfiguration; // 키를 만든 구성 (저장할 때 함께 기록합니다)
+    G4bool fStorePending;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef ProgressMonitor_h
+#define ProgressMonitor_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class ProgressMonitor
+ * @brief 런 도중 모든 워커의 진행 상황을 모아 주기적으로 출력하고 상태 파일에 쓰는 클래스입니다.
+ *
+ * 워커의 EventAction은 이벤트마다 CountEvent()/AddHits()로 전역 카운터만 올리고,
+ * 마스터 RunAction이 소유한 이 객체의 보고 스레드가 interval초마다 다음을 계산합니다.
+ * - 끝난 이벤트 수, 전체와 스레드별 처리율 (가장 느린 스레드로 낙오 스레드를 찾습니다), 남은 시간
+ * - 이벤트당 hit 수 (LS + PMT), 이번 런에서 출력 파일에 쓴 바이트 수
+ * 같은 내용을 G4cout에 한 줄로 출력하고, 배치 시스템이 읽을 수 있도록 JSON 상태 파일을 임시 파일 + 이름 바꾸기로 갱신합니다.
+ * 런이 끝나면 state가 "finished"인 마지막 상태를 씁니다.
+ */
+class ProgressMonitor
+{
+public:
+  ProgressMonitor();
+  ~ProgressMonitor();
+
+  // 마스터 RunAction에서 호출합니다. interval이 0 이하이면 아무것도 하지 않습니다.
+  void Start(G4int runID, G4long eventsToProcess, G4double interval, const G4String& statusFile);
+  void Stop();
+
+  // 워커 스레드에서 이벤트마다 호출합니다.
+  static void CountEvent();
+  static void AddHits(G4long nHits);
+
+private:
+  void Run();
+  void Report(G4bool finished);
+
+  G4int fRunID;
+  G4long fEventsToProcess;
+  G4double fInterval;
+  G4String fStatusFile;
+  G4long fBytesAtStart;
+  std::chrono::steady_clock::time_point fStartTime;
+
+  std::thread fThread;
+  std::mutex fMutex;
+  std::condition_variable fWakeUp;
+  G4bool fStopRequested;
+};
+
+#endif
@@ -3,12 +3,34 @@
 
 #include "G4UserRunAction.hh"
 #include "globals.hh"
+#include "OutputWriter.hh"
+
+#include <memory>
+
+class G4GenericMessenger;
+class ProgressMonitor;
 
 /**
  * @class RunAction
  * @brief Run의 시작과 끝에서 수행할 작업을 정의하는 클래스입니다.
  *
- * 주로 데이터 파일(ROOT)을 열고 닫으며, 생성자에서 저장할 TTree의 구조를 정의합니다.
+ * 출력 파일을 열고 닫습니다. TTree의 구조는 OutputWriter가 정의합니다.
+ * - shared 모드(기본값): 마스터(또는 순차 모드의 유일한) RunAction이 공유 OutputWriter를 엽니다.
+ * - perThread 모드: 각 워커 RunAction이 자신의 <fileName>_tN.root를 직접 씁니다.
+ *   런이 끝난 뒤 cpnr_merge(또는 merge_output CMake 타깃)로 하나의 파일로 합칩니다.
+ *
+ * 매크로 명령어:
+ * - /myApp/output/fileName : 출력 파일 이름 (확장자 제외, 기본값 cpnr_modular_sim)
+ * - /myApp/output/mode : shared 또는 perThread
+ * - /myApp/output/layout : row(Hit당 한 행, 기본값) 또는 vector(이벤트당 한 행, std::vector 컬럼)
+ * - /myApp/output/profile : full(기본값), physics, minimal (Hits / PMTHits의 컬럼 구성과 정밀도)
+ * - /myApp/output/compression, compressionLevel : ROOT 압축 알고리즘과 수준
+ * - /myApp/output/basketSize, autoFlush : <Hits|PMTHits|Events|all> <값>
+ * - /myApp/output/rollEvents, rollMegabytes : 한도에 닿으면 번호 붙은 다음 파일로 넘어갑니다 (0이면 끔)
+ * - /myApp/checkpoint/interval, resume : 주기적 체크포인트와 중단된 런의 재개 (Checkpoint 참고)
+ * - /myApp/output/histograms : OnlineHistograms를 채워 <fileName>_histos.root에 쓸지 (기본값 true)
+ * - /myApp/progress/interval, statusFile : 진행 상황 보고 주기(초, 0이면 끔)와 JSON 상태 파일 (ProgressMonitor 참고)
+ * - /myApp/output/benchmark : 현재 설정으로 합성 이벤트를 써 보고 처리량과 압축률을 출력 (런 밖에서 실행)
  */
 class RunAction : public G4UserRunAction
 {
@@ -18,6 +40,36 @@ public:
 
   virtual void BeginOfRunAction(const G4Run*) override;
   virtual void EndOfRunAction(const G4Run*) override;
+
+private:
+  void DefineCommands();
+  G4bool IsPerThreadOutput() const;
+  G4String OutputBaseName() const;
+  G4String CheckpointBaseName(G4int runID) const;
+  void PrepareCheckpoint(G4int runID);
+  void SetBasketSize(const G4String& args);
+  void SetAutoFlush(const G4String& args);
+  void Benchmark(G4int nEvents);
+  OutputWriter::Layout GetLayout() const;
+  OutputWriter::Profile GetProfile() const;
+
+  std::unique_ptr<G4GenericMessenger> fMessenger;
+  std::unique_ptr<G4GenericMessenger> fCheckpointMessenger;
+  std::unique_ptr<G4GenericMessenger> fProgressMessenger;
+  std::unique_ptr<ProgressMonitor> fProgress;   // 마스터에서만 만듭니다.
+  std::unique_ptr<OutputWriter> fThreadWriter; // perThread 모드에서 이 워커가 소유하는 writer
+  G4String fFileName;
+  G4String fOutputMode;
+  G4String fLayout;
+  G4String fProfile;
+  OutputWriter::Storage fStorage;
+  G4bool fHistograms;
+  G4int fRollEvents;
+  G4double fRollMegabytes;
+  G4int fCheckpointInterval;
+  G4bool fResume;
+  G4double fProgressInterval;
+  G4String fStatusFile;
 };
 
 #endif
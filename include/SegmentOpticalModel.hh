@@ -0,0 +1,46 @@
+#ifndef SegmentOpticalModel_h
+#define SegmentOpticalModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "SegmentRayTracer.hh"
+
+#include <memory>
+#include <vector>
+
+class G4GenericMessenger;
+
+/**
+ * @class SegmentOpticalModel
+ * @brief 세그먼트 안의 광학 광자를 SegmentRayTracer로 넘기는 Fast Simulation 모델입니다.
+ *
+ * 세그먼트를 이루는 PMMA, LS, Gd-LS 영역(G4Region)에 함께 등록되며, 세그먼트 안의 광학 광자는
+ * 첫 스텝에서 제거되고 묶음에 쌓입니다. 묶음이 가득 차거나 이벤트의 스택이 비어 Flush()가
+ * 호출되면 한꺼번에 추적하고, 검출된 광자는 PMTSD의 PMTHitsCollection에 직접 기록합니다.
+ *
+ * 매크로 명령어:
+ * - /myApp/optics/segment/batchSize : 한 번에 추적할 광자 수
+ * - /myApp/optics/segment/maxInteractions : 광자 하나당 최대 경계 상호작용 수
+ * - 모델 자체의 on/off는 Geant4 기본 명령어인 /param/InActivateModel SegmentOpticalModel 을 사용합니다.
+ */
+class SegmentOpticalModel : public G4VFastSimulationModel
+{
+public:
+  SegmentOpticalModel(const G4String& name, G4Region* envelope, const SegmentRayTracer::Config& config);
+  ~SegmentOpticalModel() override;
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+  G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+  void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+  void Flush() override;
+
+private:
+  void DefineCommands();
+
+  std::unique_ptr<SegmentRayTracer> fTracer;
+  std::unique_ptr<G4GenericMessenger> fMessenger;
+  std::vector<SegmentRayTracer::Detection> fDetections;
+  G4int fBatchSize;
+  G4int fMaxInteractions;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef SegmentRayTracer_h
+#define SegmentRayTracer_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4MaterialPropertyVector.hh"
+#include "PMTOpticalResponse.hh"
+
+#include <array>
+#include <vector>
+
+/**
+ * @class SegmentRayTracer
+ * @brief 세그먼트의 "상자 속 상자" 구조 안에서 광학 광자를 묶음(batch) 단위로 추적하는 엔진입니다.
+ *
+ * DetectorConstruction::ConstructSegment()가 만드는 세그먼트는 원점을 중심으로 정렬된
+ * 4겹의 직육면체(외부 PMMA, LS, 내부 PMMA, Gd-LS)입니다. 이 구조에서는 Geant4 내비게이터
+ * 대신 해석적인 슬랩(slab) 교차 계산만으로 경계까지의 거리를 구할 수 있습니다.
+ *
+ * - 광자 상태는 SoA(Structure of Arrays) 형태로 저장되며, 경계 거리 계산 루프는
+ *   분기 없이 작성되어 컴파일러의 자동 벡터화(SIMD) 대상이 됩니다.
+ * - 층 경계에서는 Fresnel 반사/굴절, 세그먼트 외벽에서는 공기층 + Teflon 난반사,
+ *   양 끝면의 PMT 결합 영역(그리스)을 투과한 광자는 PMTOpticalResponse로 검출 여부를 결정합니다.
+ * - PMMA 지지 기둥(Pillar)은 LS와 굴절률이 거의 같으므로 무시합니다.
+ */
+class SegmentRayTracer
+{
+public:
+  static constexpr G4int kNumLayers = 4; // 0: 외부 PMMA, 1: LS, 2: 내부 PMMA, 3: Gd-LS
+
+  struct Layer {
+    G4ThreeVector halfSize;                       // 층 바깥 상자의 반길이
+    G4MaterialPropertyVector* rindex = nullptr;    // RINDEX (없으면 광자 흡수)
+    G4MaterialPropertyVector* absLength = nullptr; // ABSLENGTH (없으면 흡수 없음)
+  };
+
+  struct Config {
+    std::array<Layer, kNumLayers> layers;
+    G4MaterialPropertyVector* greaseRindex = nullptr;      // PMT 결합 그리스의 RINDEX
+    G4MaterialPropertyVector* wrapReflectivity = nullptr;  // 외벽 Teflon 반사율
+    G4double couplingRadius = 0.;                          // 끝면에서 PMT와 결합된 원의 반지름
+    PMTOpticalResponse::Parameters pmt;                    // 양 끝 PMT의 해석적 응답
+  };
+
+  // 검출된 광자 하나 (PMTHit 생성에 필요한 정보)
+  struct Detection {
+    G4int segmentID;
+    G4int pmtID;
+    G4double time;
+  };
+
+  explicit SegmentRayTracer(const Config& config);
+  ~SegmentRayTracer();
+
+  // 세그먼트 좌표계 기준의 광자 하나를 현재 묶음에 추가합니다.
+  void AddPhoton(G4int segmentID, const G4ThreeVector& localPos, const G4ThreeVector& localDir,
+                 G4double energy, G4double globalTime);
+
+  // 쌓인 광자를 모두 추적하고 검출된 광자를 detections 뒤에 덧붙입니다. 묶음은 비워집니다.
+  void Trace(std::vector<Detection>& detections);
+
+  std::size_t GetNumberOfPhotons() const { return fX.size(); }
+
+  void SetMaxInteractions(G4int n) { fMaxInteractions = n; }
+
+private:
+  enum StepResult : G4int { kOuterBoundary = 0, kInnerBoundary = 1, kAbsorbed = 2 };
+
+  void ComputeDistances(std::size_t n);
+  G4bool Interact(std::size_t i, std::vector<Detection>& detections);
+  void EnterLayer(std::size_t i, G4int layer);
+  void Reflect(std::size_t i, G4int axis);
+  void Refract(std::size_t i, G4int axis, G4double normalSign, G4double n1, G4double n2, G4double cosI);
+  void ReflectDiffuse(std::size_t i, G4int axis, G4double normalSign, G4double n);
+  void Compact();
+  void MoveEntry(std::size_t dst, std::size_t src);
+  void Resize(std::size_t n);
+
+  G4double& Pos(std::size_t i, G4int axis) { return (axis == 0) ? fX[i] : (axis == 1) ? fY[i] : fZ[i]; }
+  G4double& Dir(std::size_t i, G4int axis) { return (axis == 0) ? fUx[i] : (axis == 1) ? fUy[i] : fUz[i]; }
+
+  Config fConfig;
+  PMTOpticalResponse fPMTResponse;
+  G4int fMaxInteractions;
+
+  // --- 광자 상태 (SoA) ---
+  std::vector<G4double> fX, fY, fZ;
+  std::vector<G4double> fUx, fUy, fUz;
+  std::vector<G4double> fTime;
+  std::vector<G4double> fEnergy;
+  std::vector<G4int> fLayer;
+  std::vector<G4int> fSegmentID;
+  std::vector<char> fAlive;
+  std::vector<std::array<G4double, kNumLayers>> fRindex; // 광자 에너지에서 평가한 층별 굴절률
+  std::vector<std::array<G4double, kNumLayers>> fAbsLength;
+
+  // --- 현재 층의 기하/광학 값 (거리 커널용으로 모아둔 배열) ---
+  std::vector<G4double> fOutHx, fOutHy, fOutHz;
+  std::vector<G4double> fInHx, fInHy, fInHz; // 안쪽 상자가 없으면 음수
+  std::vector<G4double> fCurAbs;
+
+  // --- 거리 커널의 출력 ---
+  std::vector<G4double> fRand;
+  std::vector<G4double> fDist;
+  std::vector<G4int> fAxis;
+  std::vector<G4int> fResult;
+};
+
+#endif
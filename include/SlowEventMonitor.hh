@@ -0,0 +1,85 @@
+#ifndef SlowEventMonitor_h
+#define SlowEventMonitor_h 1
+
+#include "globals.hh"
+#include "EventRecord.hh"
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+class G4Event;
+class G4GenericMessenger;
+class G4ParticleDefinition;
+class G4Track;
+
+/**
+ * @class SlowEventMonitor
+ * @brief 이벤트마다 스레드 CPU 시간을 재고, 기준을 넘은 느린 이벤트를 나중에 다시 돌릴 수 있도록 기록하는 클래스입니다.
+ *
+ * 워커 스레드마다 하나씩 EventAction이 소유합니다. 시간은 clock_gettime(CLOCK_THREAD_CPUTIME_ID)로 재므로
+ * 스레드가 코어보다 많아도 부풀려지지 않으며, EventAction이 OnlineHistograms의 이벤트 CPU 시간 분포에도 채웁니다.
+ *
+ * 기준은 절대 시간(threshold)과 이 스레드에서 지금까지 처리한 이벤트의 중앙값 배수(factor) 두 가지이며,
+ * 둘 중 하나라도 넘으면 느린 이벤트입니다. 중앙값은 로그 눈금의 계수 배열로 어림합니다.
+ * 느린 이벤트는 <fileName>_slow_events.txt에 이벤트 ID, 1차 입자, 포획 요약, 입자별 트랙/스텝 수를 덧붙이고,
+ * 1차 입자를 만들기 직전의 난수 엔진 상태를 <fileName>_slow_r<run>_e<event>.rndm에 씁니다.
+ * 이 파일은 순차 모드에서 /myApp/random/replayState로 다시 돌릴 수 있습니다 (EventSeeder 참고).
+ *
+ * 기준이 켜져 있을 때만 SteppingAction이 CountStep()으로 스텝을 세고, 엔진 상태를 G4Event에 저장하게 합니다.
+ *
+ * 매크로 명령어 (/myApp/slowEvents/):
+ * - threshold <s> : 이 CPU 시간을 넘은 이벤트를 기록합니다 (기본값 0, 끔)
+ * - factor <x> : 중앙값의 x배를 넘은 이벤트를 기록합니다 (기본값 0, 끔)
+ * - minEvents <n> : factor 기준을 쓰기 전에 필요한 이벤트 수 (기본값 100)
+ * - maxDumps <n> : 스레드와 런마다 기록할 최대 이벤트 수 (기본값 100)
+ */
+class SlowEventMonitor
+{
+public:
+  SlowEventMonitor();
+  ~SlowEventMonitor();
+
+  G4bool IsEnabled() const { return fThreshold > 0. || fFactor > 0.; }
+
+  void BeginOfEvent();
+  // SteppingAction에서 스텝마다 호출합니다 (IsEnabled()일 때만).
+  void CountStep(const G4Track* track);
+  // 이 이벤트의 CPU 시간 [s]을 돌려주고, 느린 이벤트이면 기록합니다.
+  G4double EndOfEvent(const G4Event* event, const EventSummaryRecord& summary);
+
+private:
+  // 1 us ~ 10^4 s, 10배마다 20칸
+  static constexpr G4int kBinsPerDecade = 20;
+  static constexpr G4int kNumBins = 10 * kBinsPerDecade;
+  static constexpr G4double kMinSeconds = 1e-6;
+
+  struct StepCount {
+    G4long tracks = 0;
+    G4long steps = 0;
+  };
+
+  G4double Median() const;
+  void Dump(const G4Event* event, const EventSummaryRecord& summary, G4double seconds, G4double median);
+
+  void DefineCommands();
+  void SetThreshold(G4double seconds);
+  void SetFactor(G4double factor);
+  void StoreRandomStatus();
+
+  G4double fThreshold;
+  G4double fFactor;
+  G4int fMinEvents;
+  G4int fMaxDumps;
+
+  G4double fStartTime;
+  G4int fRunID;
+  G4int fDumps;
+  G4long fEvents;
+  std::array<G4long, kNumBins> fTimeBins;
+  std::unordered_map<const G4ParticleDefinition*, StepCount> fStepCounts;
+
+  std::unique_ptr<G4GenericMessenger> fMessenger;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef StartupTimer_h
+#define StartupTimer_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+
+/**
+ * @class StartupTimer
+ * @brief 프로그램 시작부터 첫 런이 시작될 때까지의 고정 비용을 단계별로 재는 클래스입니다.
+ *
+ * 짧은 작업을 많이 돌리면 이 고정 비용이 전체 CPU 시간의 상당 부분을 차지하므로,
+ * 어느 단계를 줄여야 하는지 보이도록 마스터 스레드의 시간을 단계별로 나눠 보여줍니다.
+ * - 각 단계는 Scope 객체로 잽니다. Scope 안에 다른 Scope가 있으면 안쪽 시간은 바깥 단계에서 빠집니다.
+ * - Start() 이후 G4State_Init 상태에 머문 시간 중 다른 단계에 속하지 않은 부분(주로 물리 테이블 생성)은
+ *   "physics tables" 단계로 잡힙니다.
+ * - 워커 스레드의 Scope는 아무것도 하지 않습니다.
+ * 보고서는 마스터 RunAction이 첫 런을 시작할 때 Print()로 한 번만 출력합니다.
+ */
+class StartupTimer
+{
+public:
+  class Scope
+  {
+  public:
+    explicit Scope(const char* phase);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    const char* fPhase;
+    std::chrono::steady_clock::time_point fStart;
+    G4double fNestedSeconds;
+    Scope* fParent;
+  };
+
+  // main의 맨 앞에서 호출합니다.
+  static void Start();
+  // 처음 호출될 때만 단계별 시간을 출력합니다.
+  static void Print();
+};
+
+#endif
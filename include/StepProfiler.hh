@@ -0,0 +1,80 @@
+#ifndef StepProfiler_h
+#define StepProfiler_h 1
+
+#include "globals.hh"
+
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+
+class G4GenericMessenger;
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4Step;
+class G4Track;
+class G4VProcess;
+
+/**
+ * @class StepProfiler
+ * @brief 스텝에 걸린 CPU 시간을 (논리 볼륨, 입자, 프로세스) 조합별로 나누어 재는 표본 추출 프로파일러입니다.
+ *
+ * 워커 스레드마다 하나씩 SteppingAction이 소유하며, TrackingAction이 트랙의 시작을 알립니다.
+ * 한 스텝의 시간은 직전 스텝(또는 트랙 시작)부터 이번 UserSteppingAction 호출까지 이 스레드가 쓴 CPU 시간
+ * (CLOCK_THREAD_CPUTIME_ID)이고,
+ * 스텝이 일어난 볼륨(pre-step), 입자, 스텝을 정한 프로세스(post-step)에 더해집니다.
+ * sampling이 N이면 트랙 N개 중 하나만 재므로 시계 호출 비용도 1/N로 줄어듭니다.
+ *
+ * 스레드별 누적값은 포인터 키로 잠금 없이 쌓이고, 런이 끝나면 RunAction이 EndOfRun()을 불러
+ * 이름 키의 전역 표에 합칩니다. 마스터(또는 순차 모드)는 합친 결과를 시간 비율 순으로 출력합니다.
+ *
+ * 매크로 명령어 (/myApp/profile/):
+ * - enable <bool> : 기본값 false
+ * - sampling <N> : 트랙 N개 중 하나를 잽니다 (기본값 1)
+ * - top <N> : 출력할 조합 수 (기본값 25)
+ */
+class StepProfiler
+{
+public:
+  StepProfiler();
+  ~StepProfiler();
+
+  // TrackingAction::PreUserTrackingAction에서 호출합니다.
+  void StartTrack(const G4Track* track);
+  // SteppingAction::UserSteppingAction의 처음에서 호출합니다.
+  void Step(const G4Step* step);
+
+  G4bool IsEnabled() const { return fEnabled; }
+
+  // 모든 스레드의 RunAction::EndOfRunAction에서 호출합니다.
+  // 이 스레드의 누적값을 전역 표에 합치고, 마스터에서는 결과를 출력한 뒤 표를 비웁니다.
+  static void EndOfRun(G4bool isMaster);
+
+private:
+  using Key = std::tuple<const G4LogicalVolume*, const G4ParticleDefinition*, const G4VProcess*>;
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      const std::hash<const void*> hash;
+      return hash(std::get<0>(key)) ^ (hash(std::get<1>(key)) << 1) ^ (hash(std::get<2>(key)) << 2);
+    }
+  };
+  struct Entry {
+    G4double seconds = 0.;
+    G4long steps = 0;
+  };
+
+  void MergeAndClear();
+  void DefineCommands();
+
+  std::unordered_map<Key, Entry, KeyHash> fEntries;
+  G4double fLast;   // 직전 스텝(또는 트랙 시작)의 스레드 CPU 시간 [s]
+  G4bool fTiming;   // 현재 트랙을 재는 중인지
+  G4long fTrackCount;
+
+  G4bool fEnabled;
+  G4int fSampling;
+  G4int fTop;
+
+  std::unique_ptr<G4GenericMessenger> fMessenger;
+};
+
+#endif
@@ -3,19 +3,39 @@
 
 #include "G4UserSteppingAction.hh"
 
+#include <memory>
+
+class EventAction;
+class SlowEventMonitor;
+class StepProfiler;
+class TrackKiller;
+
 /**
  * @class SteppingAction
  * @brief 입자의 모든 스텝(step)마다 호출되는 클래스입니다.
  *
- * 이 프로젝트에서는 데이터 수집 로직을 G4VSensitiveDetector (LSSD)로 이전했기 때문에,
- * 이 클래스의 내용은 의도적으로 비워두었습니다.
+ * 데이터 수집 로직은 G4VSensitiveDetector (LSSD)가 담당하므로, 이 클래스는
+ * 1) 중성자 포획 스텝을 찾아 EventAction의 이벤트 요약에 알리고,
+ * 2) TrackKiller의 정책에 따라 더 이상 히트에 기여할 수 없는 트랙을 제거합니다.
+ * StepProfiler가 켜져 있으면 스텝마다 걸린 시간을 (볼륨, 입자, 프로세스)별로 기록합니다.
  */
 class SteppingAction : public G4UserSteppingAction
 {
 public:
-  SteppingAction();
+  explicit SteppingAction(EventAction* eventAction);
   virtual ~SteppingAction();
   virtual void UserSteppingAction(const G4Step*) override;
+
+  TrackKiller* GetTrackKiller() const { return fTrackKiller.get(); }
+  StepProfiler* GetStepProfiler() const { return fProfiler.get(); }
+
+private:
+  void RecordNeutronCapture(const G4Step* step);
+
+  EventAction* fEventAction;
+  SlowEventMonitor* fSlowEvents;
+  std::unique_ptr<TrackKiller> fTrackKiller;
+  std::unique_ptr<StepProfiler> fProfiler;
 };
 
 #endif
@@ -0,0 +1,87 @@
+#ifndef TrackKiller_h
+#define TrackKiller_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4TrackStatus.hh"
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+class G4GenericMessenger;
+class G4ParticleDefinition;
+class G4Region;
+class G4Track;
+
+/**
+ * @class TrackKiller
+ * @brief 히트에 기여할 수 없는 트랙을 일찍 제거하는 정책을 모아둔 클래스입니다.
+ *
+ * SteppingAction(매 스텝)과 TrackingAction(트랙 생성 시)이 같은 객체를 공유하며,
+ * 워커 스레드마다 하나씩 ActionInitialization::Build()에서 만들어집니다.
+ *
+ * - 전역 시간 창(timeWindow): 이 시간을 넘긴 트랙을 제거합니다 (늦게 붕괴한 방사성 핵의 자손 등).
+ * - 최소 운동 에너지(minEkine): 이 값보다 낮아진 트랙을 제거합니다 (공기 중의 열중성자 등).
+ * - 검출기 envelope 이탈: 세그먼트 배열을 감싸는 상자 밖으로 나가는 트랙을 제거합니다.
+ *
+ * 시간/에너지 규칙은 (입자 이름, 영역 이름) 쌍에 대해 지정하며 "all"은 와일드카드입니다.
+ * 가장 구체적인 규칙이 우선하고, 와일드카드 입자 규칙은 광학 광자에 적용되지 않습니다.
+ * 기본값은 모두 꺼져 있습니다.
+ *
+ * 매크로 명령어 (/myApp/killer/):
+ * - timeWindow <particle|all> <region|all> <value> <unit>
+ * - minEkine <particle|all> <region|all> <value> <unit>
+ * - killOutsideEnvelope <bool>, envelopeMargin <value> <unit>
+ * - enable <bool>, list
+ */
+class TrackKiller
+{
+public:
+  TrackKiller();
+  ~TrackKiller();
+
+  // 트랙이 생성될 때 (이미 시간 창 밖이면 true)
+  G4bool ShouldKillAtBirth(const G4Track* track);
+  // 매 스텝 후 (post-step 상태 기준). 제거하지 않으면 fAlive, 제거할 때는 새 트랙 상태를 돌려줍니다.
+  // 에너지 기준으로 멈춘 트랙은 G4UserSpecialCuts처럼 정지 상태 프로세스(붕괴, 소멸 등)가 있으면 fStopButAlive입니다.
+  G4TrackStatus CheckStep(const G4Track* track, const G4Region* region);
+
+private:
+  struct Policy {
+    G4double maxTime = DBL_MAX;
+    G4double minEkine = 0.;
+  };
+  using RuleKey = std::pair<G4String, G4String>; // (입자 이름, 영역 이름)
+  using CacheKey = std::pair<const G4ParticleDefinition*, const G4Region*>;
+  struct CacheKeyHash {
+    std::size_t operator()(const CacheKey& key) const {
+      return std::hash<const void*>()(key.first) ^ (std::hash<const void*>()(key.second) << 1);
+    }
+  };
+
+  const Policy& GetPolicy(const G4ParticleDefinition* particle, const G4Region* region);
+  G4double Resolve(const std::map<RuleKey, G4double>& rules, const G4String& particle,
+                   const G4String& region, G4bool optical, G4double fallback) const;
+  G4bool IsLeavingEnvelope(const G4Track* track) const;
+
+  void DefineCommands();
+  G4bool ParseRule(const G4String& args, RuleKey& key, G4double& value) const;
+  void SetTimeWindow(const G4String& args);
+  void SetMinEkine(const G4String& args);
+  void List();
+
+  std::map<RuleKey, G4double> fTimeRules;
+  std::map<RuleKey, G4double> fEkinRules;
+  std::unordered_map<CacheKey, Policy, CacheKeyHash> fPolicyCache;
+
+  G4bool fEnabled;
+  G4bool fKillOutsideEnvelope;
+  G4double fEnvelopeMargin;
+  G4ThreeVector fEnvelopeHalfSize;
+
+  std::unique_ptr<G4GenericMessenger> fMessenger;
+};
+
+#endif
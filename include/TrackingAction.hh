@@ -4,20 +4,28 @@
 #include "G4UserTrackingAction.hh"
 #include "globals.hh"
 
+class StepProfiler;
+class TrackKiller;
+
 /**
  * @class TrackingAction
  * @brief 입자 하나의 트랙(생성부터 소멸까지) 단위로 작업을 수행하는 클래스입니다.
  *
- * 현재 프로젝트에서는 사용하고 있지 않지만, 향후 확장을 위한 틀(placeholder)로 남겨두었습니다.
+ * 트랙이 시작될 때 이미 TrackKiller의 시간 창을 벗어난 트랙(예: 늦게 붕괴한 방사성 핵의 자손)을
+ * 첫 스텝 전에 제거합니다. StepProfiler에는 트랙의 시작 시각을 알립니다.
  */
 class TrackingAction : public G4UserTrackingAction
 {
 public:
-  TrackingAction();
+  TrackingAction(TrackKiller* killer, StepProfiler* profiler);
   virtual ~TrackingAction();
 
   virtual void PreUserTrackingAction(const G4Track* track) override;
   virtual void PostUserTrackingAction(const G4Track* track) override;
+
+private:
+  TrackKiller* fTrackKiller;
+  StepProfiler* fProfiler;
 };
 
 #endif
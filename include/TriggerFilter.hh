@@ -0,0 +1,60 @@
+#ifndef TriggerFilter_h
+#define TriggerFilter_h 1
+
+#include "globals.hh"
+#include "EventRecord.hh"
+
+#include <memory>
+#include <vector>
+
+class G4GenericMessenger;
+
+/**
+ * @class TriggerFilter
+ * @brief 이벤트를 출력할지 EventAction::EndOfEventAction()에서 결정하는 온라인 트리거입니다.
+ *
+ * 워커 스레드마다 EventAction이 하나씩 소유합니다. 거절된 이벤트는 EventRecord를 만들지 않으므로
+ * Hits / PMTHits / Events 어디에도 기록되지 않습니다. 켜져 있는 조건은 모두 만족해야(AND) 통과합니다.
+ *
+ * - minEdep: LSHit 에너지 증착 합의 하한
+ * - 세그먼트 발화: 한 세그먼트의 양쪽 PMT 광전자 합이 minSegmentPE 이상이면 발화한 것으로 봅니다.
+ *   requireBothPMTs가 켜져 있으면 양쪽 PMT 모두 광전자가 하나 이상이어야 합니다.
+ * - minSegments: 발화한 세그먼트 수의 하한 (세그먼트 coincidence, 0이면 사용하지 않음)
+ * - requireCapture: none, any(중성자 포획), Gd(Gd 핵의 포획)
+ *
+ * 통과/거절 통계는 모든 스레드에서 합산되며, 마스터 RunAction이 런의 끝에서 출력합니다.
+ *
+ * 매크로 명령어 (/myApp/trigger/):
+ * - enable <bool> (기본값 false), minEdep <value> <unit>, minSegmentPE <n>, requireBothPMTs <bool>,
+ *   minSegments <n>, requireCapture <none|any|Gd>
+ */
+class TriggerFilter
+{
+public:
+  TriggerFilter();
+  ~TriggerFilter();
+
+  /**
+   * @param summary   EventAction이 계산한 이벤트 요약 (edepTotal, nCaptures, captureTargetZ를 사용)
+   * @param channelPE PMT 채널(segmentID * 2 + pmtID)별 광전자 수
+   * @return 이벤트를 기록해야 하면 true (트리거가 꺼져 있으면 항상 true)
+   */
+  G4bool Accept(const EventSummaryRecord& summary, const std::vector<G4int>& channelPE);
+
+  static void ResetStatistics();
+  static void PrintStatistics();
+
+private:
+  void DefineCommands();
+
+  G4bool fEnabled;
+  G4double fMinEdep;
+  G4int fMinSegmentPE;
+  G4bool fRequireBothPMTs;
+  G4int fMinSegments;
+  G4String fRequireCapture;
+
+  std::unique_ptr<G4GenericMessenger> fMessenger;
+};
+
+#endif
@@ -18,7 +18,11 @@ void ActionInitialization::Build() const
 {
   SetUserAction(new PrimaryGeneratorAction());
   SetUserAction(new RunAction());
-  SetUserAction(new EventAction());
-  SetUserAction(new SteppingAction());
-  SetUserAction(new TrackingAction());
+  auto eventAction = new EventAction();
+  SetUserAction(eventAction);
+
+  // 트랙 제거 정책(TrackKiller)과 StepProfiler는 SteppingAction이 소유하고 TrackingAction과 공유합니다.
+  auto steppingAction = new SteppingAction(eventAction);
+  SetUserAction(steppingAction);
+  SetUserAction(new TrackingAction(steppingAction->GetTrackKiller(), steppingAction->GetStepProfiler()));
 }
@@ -0,0 +1,176 @@
+#include "AdaptiveTaskRunManager.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Event.hh"
+#include "G4GenericMessenger.hh"
+#include "G4RNGHelper.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+G4Mutex batchMutex = G4MUTEX_INITIALIZER;
+
+// 이번 런에서 끝난 이벤트의 누적 비용. 이벤트마다 한 번씩만 갱신합니다.
+std::atomic<G4long> costNanoseconds(0);
+std::atomic<G4long> costEvents(0);
+
+// 평균을 믿기 전에 필요한 이벤트 수. 그 전에는 한 개씩 나눠 주며 비용을 잽니다.
+constexpr G4long kMinSamples = 8;
+
+// 워커 스레드에서 지금 실행 중인 task의 상태. 워커는 task 하나의 루프를 끝낸 뒤에 다음 task를 시작합니다.
+struct TaskState {
+  G4int run = -1;
+  G4int loopLeft = 0;    // 이 task의 이벤트 루프에 남은 횟수 (0이면 다음 요청은 새 task)
+  G4bool claimed = false; // 이 task가 이미 묶음을 받았는지
+};
+G4ThreadLocal TaskState* taskState = nullptr;
+}
+
+AdaptiveTaskRunManager::AdaptiveTaskRunManager()
+: G4TaskRunManager(),
+  fAdaptive(true),
+  fBatchSeconds(2.),
+  fTailFactor(2.),
+  fMaxBatch(1000),
+  fNumberOfBatches(0),
+  fRunGeneration(0)
+{
+  DefineCommands();
+}
+
+AdaptiveTaskRunManager::~AdaptiveTaskRunManager() {}
+
+void AdaptiveTaskRunManager::DefineCommands()
+{
+  fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/run/", "Event dispatch of the tasking run manager");
+  auto& adaptiveCmd = fMessenger->DeclareProperty("adaptiveBatching", fAdaptive,
+      "Size event batches from the measured per-event cost (false: fixed /run/eventModulo)");
+  adaptiveCmd.SetToBeBroadcasted(false);
+  auto& secondsCmd = fMessenger->DeclareProperty("batchSeconds", fBatchSeconds,
+      "Target wall time of one event batch in seconds");
+  secondsCmd.SetToBeBroadcasted(false);
+  auto& tailCmd = fMessenger->DeclareProperty("tailFactor", fTailFactor,
+      "Batches never exceed remaining events / (tailFactor * threads)");
+  tailCmd.SetToBeBroadcasted(false);
+  auto& maxCmd = fMessenger->DeclareProperty("maxBatch", fMaxBatch, "Upper bound of the batch size");
+  maxCmd.SetToBeBroadcasted(false);
+}
+
+void AdaptiveTaskRunManager::RecordEventCost(G4double seconds)
+{
+  costNanoseconds.fetch_add(static_cast<G4long>(seconds * 1e9), std::memory_order_relaxed);
+  costEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AdaptiveTaskRunManager::InitializeEventLoop(G4int n_event, const char* macroFile, G4int n_select)
+{
+  // 물리 설정이나 선원이 바뀌면 비용도 달라지므로 런마다 새로 잽니다.
+  costNanoseconds = 0;
+  costEvents = 0;
+  fNumberOfBatches = 0;
+  ++fRunGeneration;
+  G4TaskRunManager::InitializeEventLoop(n_event, macroFile, n_select);
+}
+
+G4int AdaptiveTaskRunManager::NextBatchSize() const
+{
+  const G4int remaining = numberOfEventToBeProcessed - numberOfEventProcessed;
+  const G4int nThreads = std::max(1, GetNumberOfThreads());
+  G4double batch = std::ceil(remaining / (std::max(1., fTailFactor) * nThreads));
+
+  const G4long samples = costEvents.load(std::memory_order_relaxed);
+  if (samples < kMinSamples) {
+    batch = 1.;
+  }
+  else {
+    const G4double meanCost = 1e-9 * costNanoseconds.load(std::memory_order_relaxed) / samples;
+    if (meanCost > 0.) batch = std::min(batch, fBatchSeconds / meanCost);
+  }
+  return static_cast<G4int>(std::clamp(batch, 1., static_cast<G4double>(std::max(1, fMaxBatch))));
+}
+
+G4int AdaptiveTaskRunManager::HandOut(G4Event* event, G4SeedsQueue* seedsQueue, G4bool reseedRequired, G4int nEvents)
+{
+  // G4TaskRunManager::SetUpNEvents와 같은 방식으로 이벤트 ID와 시드를 넘겨주되, 개수만 nEvents로 정합니다.
+  event->SetEventID(numberOfEventProcessed);
+  if (reseedRequired) {
+    G4RNGHelper* helper = G4RNGHelper::GetInstance();
+    const G4int nSeeds = (SeedOncePerCommunication() > 0) ? 1 : nEvents;
+    for (G4int i = 0; i < nSeeds; ++i) {
+      seedsQueue->push(helper->GetSeed(nSeedsUsed));
+      seedsQueue->push(helper->GetSeed(nSeedsUsed + 1));
+      if (nSeedsPerEvent == 3) seedsQueue->push(helper->GetSeed(nSeedsUsed + 2));
+      ++nSeedsUsed;
+      if (nSeedsUsed == nSeedsFilled) RefillSeeds();
+    }
+  }
+  numberOfEventProcessed += nEvents;
+  ++fNumberOfBatches;
+  return nEvents;
+}
+
+G4int AdaptiveTaskRunManager::SetUpNEvents(G4Event* event, G4SeedsQueue* seedsQueue, G4bool reseedRequired)
+{
+  if (!fAdaptive) return G4TaskRunManager::SetUpNEvents(event, seedsQueue, reseedRequired);
+
+  // eventModulo와 numberOfEventsPerTask는 실행 중인 task의 루프 길이이므로 건드리지 않습니다.
+  G4AutoLock lock(&batchMutex);
+  if (!taskState) taskState = new TaskState;
+  TaskState& task = *taskState;
+  if (task.run != fRunGeneration) task = TaskState{fRunGeneration, 0, false};
+  if (task.loopLeft == 0) {
+    // 새 task: 루프 길이는 InitializeEventLoop에서 정해진 값입니다.
+    task.loopLeft = std::max(1, numberOfEventsPerTask);
+    task.claimed = false;
+  }
+
+  const G4int remaining = numberOfEventToBeProcessed - numberOfEventProcessed;
+  if (remaining <= 0 || task.claimed) {
+    // 묶음을 끝낸 task는 여기서 끝납니다. 남은 이벤트가 있으면 task 수가 줄지 않도록 하나를 더 넣습니다.
+    task.loopLeft = 0;
+    const G4int taskIndex = fNumberOfBatches;
+    lock.unlock();
+    if (remaining > 0) AddEventTask(taskIndex);
+    return 0;
+  }
+
+  const G4int batch = std::min({NextBatchSize(), remaining, task.loopLeft});
+  task.loopLeft -= batch;
+  task.claimed = true;
+  const G4int handedOut = HandOut(event, seedsQueue, reseedRequired, batch);
+
+  // 묶음이 루프를 다 쓰면 워커가 더는 묻지 않고 task를 끝내므로, 대신할 task를 여기서 바로 넣습니다.
+  // 그렇지 않으면 동시에 도는 task 수가 줄고, 꼬리가 RunTermination의 대기 단위로 끊깁니다.
+  const G4bool replace = (task.loopLeft == 0 && remaining > batch);
+  const G4int taskIndex = fNumberOfBatches;
+  lock.unlock();
+  if (replace) AddEventTask(taskIndex);
+  return handedOut;
+}
+
+void AdaptiveTaskRunManager::RunTermination()
+{
+  if (fAdaptive && !fakeRun) {
+    // 워커 쪽에서 task를 더 넣지 못한 경우에 대비해, 모든 이벤트를 넘겨줄 때까지 task를 더 넣습니다.
+    while (!runAborted) {
+      workTaskGroup->wait();
+      G4AutoLock lock(&batchMutex);
+      if (numberOfEventProcessed >= numberOfEventToBeProcessed) break;
+      lock.unlock();
+      for (G4int i = 0; i < std::max(1, GetNumberOfThreads()); ++i) AddEventTask(i);
+    }
+  }
+  G4TaskRunManager::RunTermination();
+
+  // 이벤트 ID는 0부터 연속으로 넘겨주므로, 넘겨준 수와 끝난 수가 모두 요청과 같으면 빠진 ID가 없습니다.
+  const G4long finished = costEvents.load();
+  if (fAdaptive && !fakeRun && !runAborted &&
+      (numberOfEventProcessed != numberOfEventToBeProcessed || finished != numberOfEventToBeProcessed)) {
+    G4ExceptionDescription message;
+    message << numberOfEventToBeProcessed << " events requested, " << numberOfEventProcessed
+            << " event IDs handed out, " << finished << " events finished.";
+    G4Exception("AdaptiveTaskRunManager::RunTermination()", "EventCountMismatch", JustWarning, message);
+  }
+}
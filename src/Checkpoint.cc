@@ -0,0 +1,123 @@
+#include "Checkpoint.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace {
+Checkpoint completed;
+}
+
+Checkpoint::Checkpoint()
+: fRunID(0),
+  fResumeCount(0)
+{}
+
+void Checkpoint::InsertRange(G4int first, G4int last)
+{
+  if (last < first) return;
+
+  // 앞쪽 구간과 겹치거나 맞닿으면 합칩니다.
+  auto it = fRanges.upper_bound(first);
+  if (it != fRanges.begin()) {
+    auto prev = std::prev(it);
+    if (static_cast<G4long>(prev->second) + 1 >= first) {
+      first = prev->first;
+      last = std::max(last, prev->second);
+      it = fRanges.erase(prev);
+    }
+  }
+  // 뒤쪽으로 겹치거나 맞닿는 구간을 모두 흡수합니다.
+  while (it != fRanges.end() && it->first <= static_cast<G4long>(last) + 1) {
+    last = std::max(last, it->second);
+    it = fRanges.erase(it);
+  }
+  fRanges.emplace(first, last);
+}
+
+void Checkpoint::Merge(const Checkpoint& other)
+{
+  for (const auto& range : other.fRanges) InsertRange(range.first, range.second);
+  fResumeCount = std::max(fResumeCount, other.fResumeCount);
+}
+
+G4bool Checkpoint::Contains(G4int eventID) const
+{
+  auto it = fRanges.upper_bound(eventID);
+  if (it == fRanges.begin()) return false;
+  return eventID <= std::prev(it)->second;
+}
+
+G4long Checkpoint::GetNumberOfEvents() const
+{
+  G4long n = 0;
+  for (const auto& range : fRanges) n += static_cast<G4long>(range.second) - range.first + 1;
+  return n;
+}
+
+G4bool Checkpoint::Save(const G4String& fileName) const
+{
+  const G4String temporary = fileName + ".tmp";
+  {
+    std::ofstream out(temporary);
+    if (!out) return false;
+    out << "# CPNR_modular_sim checkpoint\n";
+    out << "run " << fRunID << "\n";
+    out << "resumeCount " << fResumeCount << "\n";
+    out << "output " << fOutputFile << "\n";
+    out << "events";
+    for (const auto& range : fRanges) {
+      out << ' ' << range.first;
+      if (range.second != range.first) out << '-' << range.second;
+    }
+    out << "\n";
+    out.flush();
+    if (!out) return false;
+  }
+  return std::rename(temporary.c_str(), fileName.c_str()) == 0;
+}
+
+G4bool Checkpoint::Load(const G4String& fileName)
+{
+  std::ifstream in(fileName);
+  if (!in) return false;
+
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream is(line);
+    std::string key;
+    if (!(is >> key) || key[0] == '#') continue;
+    if (key == "run") {
+      is >> fRunID;
+    }
+    else if (key == "resumeCount") {
+      G4int count = 0;
+      if (is >> count) fResumeCount = std::max(fResumeCount, count);
+    }
+    else if (key == "output") {
+      is >> fOutputFile;
+    }
+    else if (key == "events") {
+      std::string token;
+      while (is >> token) {
+        G4int first = 0, last = 0;
+        const int n = std::sscanf(token.c_str(), "%d-%d", &first, &last);
+        if (n == 1) InsertRange(first, first);
+        else if (n == 2) InsertRange(first, last);
+      }
+    }
+  }
+  return true;
+}
+
+const Checkpoint& Checkpoint::Completed()
+{
+  return completed;
+}
+
+void Checkpoint::SetCompleted(const Checkpoint& checkpoint)
+{
+  completed = checkpoint;
+}
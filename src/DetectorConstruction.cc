@@ -17,10 +17,27 @@
 #include "G4LogicalSkinSurface.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4RotationMatrix.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4UserLimits.hh"
+#include "G4FastSimulationManager.hh"
+#include "G4GenericMessenger.hh"
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
 
 #include "LSSD.hh"
 #include "PMTSD.hh"
+#include "SegmentOpticalModel.hh"
+#include "PMTOpticalModel.hh"
+#include "GdCaptureBiasingOperator.hh"
+#include "StartupTimer.hh"
 #include <cmath>
+#include <initializer_list>
+#include <iomanip>
+#include <sstream>
 #include <vector>
 
 DetectorConstruction::DetectorConstruction()
@@ -33,6 +50,7 @@ DetectorConstruction::DetectorConstruction()
    fLogicLS_inner(nullptr), fLogicLS_outer(nullptr), fLogicPhotocathode(nullptr)
 {
     DefineMaterials();
+    DefineCommands();
 }
 
 DetectorConstruction::~DetectorConstruction() {}
@@ -95,6 +113,10 @@ void DetectorConstruction::DefineMaterials()
     glassMPT->AddProperty("RINDEX", photonEnergies, std::vector<G4double>(photonEnergies.size(), 1.47));
     fGlassMaterial->SetMaterialPropertiesTable(glassMPT);
 
+    auto pmmaMPT = new G4MaterialPropertiesTable();
+    pmmaMPT->AddProperty("RINDEX", photonEnergies, std::vector<G4double>(photonEnergies.size(), 1.49));
+    fPmmaMaterial->SetMaterialPropertiesTable(pmmaMPT);
+
     auto greaseMPT = new G4MaterialPropertiesTable();
     greaseMPT->AddProperty("RINDEX", photonEnergies, std::vector<G4double>(photonEnergies.size(), 1.45));
     fSiliconeGrease->SetMaterialPropertiesTable(greaseMPT);
@@ -120,6 +142,7 @@ void DetectorConstruction::DefineMaterials()
 
 G4VPhysicalVolume* DetectorConstruction::Construct()
 {
+    StartupTimer::Scope timer("geometry");
     auto solidWorld = new G4Box("SolidWorld", kWorldX/2, kWorldY/2, kWorldZ/2);
     auto logicWorld = new G4LogicalVolume(solidWorld, fWorldMaterial, "LogicWorld");
     auto physWorld = new G4PVPlacement(nullptr, G4ThreeVector(), logicWorld, "PhysWorld", nullptr, false, 0, true);
@@ -127,13 +150,15 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 
     G4LogicalVolume* logicSegment = ConstructSegment();
     G4LogicalVolume* logicPMT = ConstructPMT();
+
+    DefineRegions(logicSegment, logicPMT);
     
     auto logicGrease = new G4LogicalVolume(new G4Tubs("SolidGrease", 0, kPmtFaceRadius, kGreaseThickness/2.0, 0, CLHEP::twopi),
                                            fSiliconeGrease, "LogicGrease");
     logicGrease->SetVisAttributes(new G4VisAttributes(G4Colour(0.8, 0.8, 0.8, 0.2)));
 
-    G4double pitchX = kSegmentWidth + 5.0*cm;
-    G4double pitchY = kSegmentHeight + 5.0*cm;
+    G4double pitchX = kSegmentWidth + kSegmentGap;
+    G4double pitchY = kSegmentHeight + kSegmentGap;
 
     for (G4int j = 0; j < kNy; ++j) {
         for (G4int i = 0; i < kNx; ++i) {
@@ -222,6 +247,7 @@ G4LogicalVolume* DetectorConstruction::ConstructSegment()
     auto solidOuterPmma = new G4Box("SolidOuterPmma", kSegmentWidth/2, kSegmentHeight/2, kSegmentLength/2);
     auto logicOuterPmma = new G4LogicalVolume(solidOuterPmma, fPmmaMaterial, "LogicOuterPmma");
     logicOuterPmma->SetVisAttributes(new G4VisAttributes(G4Colour(0.0, 1.0, 1.0, 0.1)));
+    fLogicOuterPmma = logicOuterPmma;
 
     G4double outerLS_width = kSegmentWidth - 2 * kOuterPmmaThickness;
     G4double outerLS_height = kSegmentHeight - 2 * kOuterPmmaThickness;
@@ -234,6 +260,7 @@ G4LogicalVolume* DetectorConstruction::ConstructSegment()
     auto solidInnerPmma = new G4Box("SolidInnerPmma", kInnerContainerWidth/2, kInnerContainerHeight/2, kInnerContainerLength/2);
     auto logicInnerPmma = new G4LogicalVolume(solidInnerPmma, fPmmaMaterial, "LogicInnerPmma");
     logicInnerPmma->SetVisAttributes(new G4VisAttributes(G4Colour(0.0, 0.8, 0.8, 0.3)));
+    fLogicInnerPmma = logicInnerPmma;
     new G4PVPlacement(nullptr, G4ThreeVector(0,0,0), logicInnerPmma, "PhysInnerPmma", fLogicLS_outer, false, 0, true);
 
     G4double innerLS_width = kInnerContainerWidth - 2 * kInnerPmmaThickness;
@@ -272,6 +299,153 @@ G4LogicalVolume* DetectorConstruction::ConstructSegment()
     return logicOuterPmma;
 }
 
+void DetectorConstruction::DefineRegions(G4LogicalVolume* logicSegment, G4LogicalVolume* logicPMT)
+{
+    // 각 영역은 기본 컷을 복사한 자신만의 G4ProductionCuts를 가지므로, 영역별로 독립적으로 바꿀 수 있습니다.
+    // 나머지(월드의 공기, 그리스)는 DefaultRegionForTheWorld에 남으며 /run/setCut 값을 따릅니다.
+    auto makeRegion = [](const G4String& name, std::initializer_list<G4LogicalVolume*> roots) {
+        auto region = new G4Region(name);
+        for (auto logical : roots) {
+            if (logical) region->AddRootLogicalVolume(logical);
+        }
+        auto defaultCuts = G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+        region->SetProductionCuts(new G4ProductionCuts(*defaultCuts));
+        return region;
+    };
+
+    // PMMA 영역은 세그먼트 광학 Fast Simulation 모델의 envelope이기도 합니다.
+    // 내부 PMMA는 LS 안에 놓여 있으므로 별도의 root로 다시 지정합니다. 기둥은 회전되어 놓여 있어
+    // envelope으로 삼으면 좌표계가 세그먼트와 달라지므로, root로 두지 않고 LS 영역을 물려받게 합니다.
+    makeRegion("PMMARegion", {logicSegment, fLogicInnerPmma});
+    makeRegion("LSRegion", {fLogicLS_outer});
+    makeRegion("GdLSRegion", {fLogicLS_inner});
+    // PMT 영역은 PMT 광학 Fast Simulation 모델의 envelope이기도 합니다.
+    makeRegion("PMTRegion", {logicPMT});
+
+    for (const auto& entry : fRegionLimits) ApplyRegionLimits(entry.first);
+}
+
+void DetectorConstruction::DefineCommands()
+{
+    fRegionMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/region/", "Per-region production cuts and user limits");
+
+    auto& cutCmd = fRegionMessenger->DeclareMethod("setCut", &DetectorConstruction::SetRegionCut,
+        "Set the production cut of a region: <GdLS|LS|PMMA|PMT|World> <value> <unit>");
+    cutCmd.SetToBeBroadcasted(false);
+
+    auto& timeCmd = fRegionMessenger->DeclareMethod("setMaxTime", &DetectorConstruction::SetRegionMaxTime,
+        "Kill tracks whose global time exceeds the limit in a region: <region> <value> <unit>");
+    timeCmd.SetToBeBroadcasted(false);
+
+    auto& ekinCmd = fRegionMessenger->DeclareMethod("setMinEkine", &DetectorConstruction::SetRegionMinEkine,
+        "Kill tracks whose kinetic energy falls below the limit in a region: <region> <value> <unit>");
+    ekinCmd.SetToBeBroadcasted(false);
+
+    auto& listCmd = fRegionMessenger->DeclareMethod("list", &DetectorConstruction::ListRegions,
+        "Print cuts and user limits of all detector regions");
+    listCmd.SetToBeBroadcasted(false);
+}
+
+G4Region* DetectorConstruction::FindRegion(const G4String& name) const
+{
+    auto store = G4RegionStore::GetInstance();
+    if (name == "World") return store->GetRegion("DefaultRegionForTheWorld", false);
+    return store->GetRegion(name + "Region", false);
+}
+
+G4bool DetectorConstruction::ParseRegionQuantity(const G4String& args, G4String& regionName, G4double& value) const
+{
+    std::istringstream is(args);
+    G4String unit;
+    if (!(is >> regionName >> value >> unit)) {
+        G4cout << "### /myApp/region: expected <region> <value> <unit>, got \"" << args << "\"" << G4endl;
+        return false;
+    }
+    // "GdLSRegion"과 "GdLS"를 같은 영역으로 취급합니다.
+    const G4String suffix = "Region";
+    if (regionName.size() > suffix.size() &&
+        regionName.compare(regionName.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        regionName.erase(regionName.size() - suffix.size());
+    }
+    value *= G4UIcommand::ValueOf(unit);
+    return true;
+}
+
+void DetectorConstruction::SetRegionCut(const G4String& args)
+{
+    G4String regionName;
+    G4double cut = 0.;
+    if (!ParseRegionQuantity(args, regionName, cut)) return;
+
+    // 월드 영역의 컷은 물리 리스트의 기본 컷이므로 Geant4 기본 명령어로 넘깁니다.
+    if (regionName == "World") {
+        std::ostringstream cmd;
+        cmd << "/run/setCut " << cut / mm << " mm";
+        G4UImanager::GetUIpointer()->ApplyCommand(cmd.str());
+        return;
+    }
+
+    auto region = FindRegion(regionName);
+    if (!region || !region->GetProductionCuts()) {
+        G4cout << "### /myApp/region/setCut: unknown region " << regionName << G4endl;
+        return;
+    }
+    region->GetProductionCuts()->SetProductionCut(cut);
+    G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+}
+
+void DetectorConstruction::SetRegionMaxTime(const G4String& args)
+{
+    G4String regionName;
+    G4double maxTime = 0.;
+    if (!ParseRegionQuantity(args, regionName, maxTime)) return;
+    fRegionLimits[regionName].maxTime = maxTime;
+    ApplyRegionLimits(regionName);
+}
+
+void DetectorConstruction::SetRegionMinEkine(const G4String& args)
+{
+    G4String regionName;
+    G4double minEkine = 0.;
+    if (!ParseRegionQuantity(args, regionName, minEkine)) return;
+    fRegionLimits[regionName].minEkine = minEkine;
+    ApplyRegionLimits(regionName);
+}
+
+void DetectorConstruction::ApplyRegionLimits(const G4String& regionName)
+{
+    // 영역이 아직 만들어지지 않았으면 Construct()에서 다시 적용됩니다.
+    auto region = FindRegion(regionName);
+    if (!region) return;
+
+    // G4UserLimits는 G4StepLimiterPhysics가 등록하는 G4UserSpecialCuts가 읽습니다.
+    auto limits = region->GetUserLimits();
+    if (!limits) {
+        limits = new G4UserLimits();
+        region->SetUserLimits(limits);
+    }
+    const RegionLimits& requested = fRegionLimits[regionName];
+    limits->SetUserMaxTime(requested.maxTime);
+    limits->SetUserMinEkine(requested.minEkine);
+}
+
+void DetectorConstruction::ListRegions()
+{
+    for (const char* name : {"GdLS", "LS", "PMMA", "PMT", "World"}) {
+        auto region = FindRegion(name);
+        if (!region) continue;
+        auto cuts = region->GetProductionCuts();
+        G4cout << "  " << std::setw(26) << std::left << region->GetName()
+               << " cut: " << (cuts ? cuts->GetProductionCut(0) / mm : 0.) << " mm";
+        auto it = fRegionLimits.find(name);
+        if (it != fRegionLimits.end()) {
+            G4cout << ", maxTime: " << it->second.maxTime / ns << " ns"
+                   << ", minEkine: " << it->second.minEkine / keV << " keV";
+        }
+        G4cout << G4endl;
+    }
+}
+
 void DetectorConstruction::ConstructSDandField()
 {
     auto sdManager = G4SDManager::GetSDMpointer();
@@ -286,4 +460,83 @@ void DetectorConstruction::ConstructSDandField()
         sdManager->AddNewDetector(pmtSD);
         SetSensitiveDetector(fLogicPhotocathode, pmtSD);
     }
+
+    // Gd-LS 안의 중성자 포획 biasing (스레드별 생성, /myApp/bias/gdCapture/enable 로 켬)
+    if (fLogicLS_inner) {
+        auto captureBiasing = new GdCaptureBiasingOperator();
+        captureBiasing->AttachTo(fLogicLS_inner);
+    }
+
+    // 세그먼트 내부 광학 광자를 배치 광선 추적으로 처리하는 Fast Simulation 모델 (스레드별 생성)
+    // 세그먼트 안의 LS, Gd-LS 영역은 PMMA 영역과 별개이므로 같은 모델을 각 영역에도 등록합니다.
+    auto regionStore = G4RegionStore::GetInstance();
+    auto pmmaRegion = regionStore->GetRegion("PMMARegion", false);
+    if (pmmaRegion) {
+        auto segmentModel = new SegmentOpticalModel("SegmentOpticalModel", pmmaRegion, MakeSegmentOpticsConfig());
+        for (const char* name : {"LSRegion", "GdLSRegion"}) {
+            auto region = regionStore->GetRegion(name, false);
+            if (!region) continue;
+            auto manager = region->GetFastSimulationManager();
+            if (!manager) manager = new G4FastSimulationManager(region);
+            manager->AddFastSimulationModel(segmentModel);
+        }
+    }
+
+    // PMT 입사창으로 들어온 광학 광자의 검출을 해석적으로 결정하는 Fast Simulation 모델
+    auto pmtRegion = regionStore->GetRegion("PMTRegion", false);
+    if (pmtRegion) {
+        new PMTOpticalModel("PMTOpticalModel", pmtRegion, kPmtHeight, MakePMTOpticsParameters());
+    }
+}
+
+SegmentRayTracer::Config DetectorConstruction::MakeSegmentOpticsConfig() const
+{
+    auto rindexOf = [](G4Material* mat) -> G4MaterialPropertyVector* {
+        auto mpt = mat ? mat->GetMaterialPropertiesTable() : nullptr;
+        return mpt ? mpt->GetProperty("RINDEX") : nullptr;
+    };
+    auto absLengthOf = [](G4Material* mat) -> G4MaterialPropertyVector* {
+        auto mpt = mat ? mat->GetMaterialPropertiesTable() : nullptr;
+        return mpt ? mpt->GetProperty("ABSLENGTH") : nullptr;
+    };
+
+    SegmentRayTracer::Config config;
+    const G4double outerLS_width = kSegmentWidth - 2 * kOuterPmmaThickness;
+    const G4double outerLS_height = kSegmentHeight - 2 * kOuterPmmaThickness;
+    const G4double outerLS_length = kSegmentLength - 2 * kOuterPmmaThickness;
+    const G4double innerLS_width = kInnerContainerWidth - 2 * kInnerPmmaThickness;
+    const G4double innerLS_height = kInnerContainerHeight - 2 * kInnerPmmaThickness;
+    const G4double innerLS_length = kInnerContainerLength - 2 * kInnerPmmaThickness;
+
+    config.layers[0].halfSize = G4ThreeVector(kSegmentWidth/2, kSegmentHeight/2, kSegmentLength/2);
+    config.layers[1].halfSize = G4ThreeVector(outerLS_width/2, outerLS_height/2, outerLS_length/2);
+    config.layers[2].halfSize = G4ThreeVector(kInnerContainerWidth/2, kInnerContainerHeight/2, kInnerContainerLength/2);
+    config.layers[3].halfSize = G4ThreeVector(innerLS_width/2, innerLS_height/2, innerLS_length/2);
+
+    G4Material* layerMaterials[SegmentRayTracer::kNumLayers] = {fPmmaMaterial, fLsMaterial, fPmmaMaterial, fGdLsMaterial};
+    for (G4int k = 0; k < SegmentRayTracer::kNumLayers; ++k) {
+        config.layers[k].rindex = rindexOf(layerMaterials[k]);
+        config.layers[k].absLength = absLengthOf(layerMaterials[k]);
+    }
+
+    config.greaseRindex = rindexOf(fSiliconeGrease);
+    auto teflonMPT = fTeflonSurface ? fTeflonSurface->GetMaterialPropertiesTable() : nullptr;
+    config.wrapReflectivity = teflonMPT ? teflonMPT->GetProperty("REFLECTIVITY") : nullptr;
+    config.couplingRadius = kPmtFaceRadius;
+    config.pmt = MakePMTOpticsParameters();
+    return config;
+}
+
+PMTOpticalResponse::Parameters DetectorConstruction::MakePMTOpticsParameters() const
+{
+    PMTOpticalResponse::Parameters parameters;
+    auto greaseMPT = fSiliconeGrease ? fSiliconeGrease->GetMaterialPropertiesTable() : nullptr;
+    parameters.greaseRindex = greaseMPT ? greaseMPT->GetProperty("RINDEX") : nullptr;
+    auto pmtMPT = fPhotocathodeMaterial ? fPhotocathodeMaterial->GetMaterialPropertiesTable() : nullptr;
+    parameters.quantumEfficiency = pmtMPT ? pmtMPT->GetProperty("EFFICIENCY") : nullptr;
+    // ConstructPMT()의 진공 polycone과 광음극 원판 배치를 그대로 따릅니다.
+    parameters.windowRadius = kPmtFaceRadius - kPmtGlassThickness;
+    parameters.cathodeRadius = kPmtNeckRadius - kPmtGlassThickness;
+    parameters.cathodeDepth = kPmtHeight - kPmtNeckLength - kPhotocathodeThickness;
+    return parameters;
 }
@@ -1,5 +1,11 @@
 #include "EventAction.hh"
-#include "G4AnalysisManager.hh"
+#include "AdaptiveTaskRunManager.hh"
+#include "Checkpoint.hh"
+#include "OnlineHistograms.hh"
+#include "OutputWriter.hh"
+#include "ProgressMonitor.hh"
+#include "SlowEventMonitor.hh"
+#include "TriggerFilter.hh"
 #include "G4Event.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4SDManager.hh"
@@ -9,79 +15,170 @@
 #include "LSHit.hh"
 #include "PMTHit.hh"
 
+#include <algorithm>
+
 /**
  * @brief 생성자
  */
-EventAction::EventAction() : G4UserEventAction() {}
+EventAction::EventAction()
+: G4UserEventAction(),
+  fTrigger(std::make_unique<TriggerFilter>()),
+  fSlowEvents(std::make_unique<SlowEventMonitor>()),
+  fLSHitsCollectionID(-1),
+  fPMTHitsCollectionID(-1)
+{}
 
 /**
  * @brief 소멸자
  */
 EventAction::~EventAction() {}
 
+void EventAction::BeginOfEventAction(const G4Event* /*event*/)
+{
+  fSummary = EventSummaryRecord();
+  fStartTime = std::chrono::steady_clock::now();
+  fSlowEvents->BeginOfEvent();
+}
+
+void EventAction::AddNeutronCapture(const G4ThreeVector& position, G4double time, G4int targetZ, G4int targetA,
+                                    G4int nGammas, G4double gammaEnergy, G4double weight)
+{
+  if (fSummary.nCaptures++ > 0) return;
+  fSummary.captureX = position.x() / mm;
+  fSummary.captureY = position.y() / mm;
+  fSummary.captureZ = position.z() / mm;
+  fSummary.captureTime = time / ns;
+  fSummary.captureTargetZ = targetZ;
+  fSummary.captureTargetA = targetA;
+  fSummary.captureGammaMultiplicity = nGammas;
+  fSummary.captureGammaEnergy = gammaEnergy / MeV;
+  fSummary.captureWeight = weight;
+}
+
 /**
  * @brief 각 이벤트가 끝날 때마다 호출되는 함수입니다.
  * @param event 현재 이벤트에 대한 정보를 담고 있는 G4Event 객체 포인터
  *
- * 이 함수는 LSSD와 PMTSD에서 수집된 HitsCollection을 분석하여,
- * 1) 상세 에너지 증착 정보를 'Hits' TTree에 저장하고,
- * 2) PMT에서 검출된 광자 정보를 'PMTHits' TTree에 저장하는 역할을 수행합니다.
+ * LSSD와 PMTSD에서 수집된 HitsCollection으로 먼저 이벤트 요약을 계산하고 트리거 조건을 검사합니다.
+ * 통과한 이벤트만 EventRecord로 옮겨 OutputWriter의 쓰기 스레드로 넘기고 곧바로 반환합니다.
+ * 1) 상세 에너지 증착 정보는 'Hits' TTree,
+ * 2) PMT에서 검출된 광자 정보는 'PMTHits' TTree,
+ * 3) 이벤트 요약(에너지 합, 중성자 포획, 광전자 수)은 'Events' TTree에 기록됩니다.
  */
 
 void EventAction::EndOfEventAction(const G4Event* event)
 {
-  auto analysisManager = G4AnalysisManager::Instance();
-  G4int eventID = event->GetEventID();
+  const std::chrono::duration<G4double> eventTime = std::chrono::steady_clock::now() - fStartTime;
+  AdaptiveTaskRunManager::RecordEventCost(eventTime.count());
+  ProgressMonitor::CountEvent();
 
-  // --- LS 데이터 처리 (LSHitsCollection) ---
-  G4int lsHcID = G4SDManager::GetSDMpointer()->GetCollectionID("LSHitsCollection");
-  if (lsHcID >= 0) {
-    auto lsHitsCollection = static_cast<LSHitsCollection*>(event->GetHCofThisEvent()->GetHC(lsHcID));
-    if (lsHitsCollection && lsHitsCollection->entries() > 0) {
-      for (size_t i = 0; i < lsHitsCollection->entries(); ++i) {
-        auto hit = (*lsHitsCollection)[i];
-
-        // --- 기본 정보 채우기 ---
-        analysisManager->FillNtupleIColumn(0, 0, eventID);
-        analysisManager->FillNtupleIColumn(0, 1, hit->GetTrackID());
-        analysisManager->FillNtupleIColumn(0, 2, hit->GetParentID());
-        analysisManager->FillNtupleSColumn(0, 3, hit->GetParticleName());
-        analysisManager->FillNtupleSColumn(0, 4, hit->GetProcessName());
-        analysisManager->FillNtupleSColumn(0, 5, hit->GetVolumeName());
-        analysisManager->FillNtupleDColumn(0, 6, hit->GetPosition().x() / mm);
-        analysisManager->FillNtupleDColumn(0, 7, hit->GetPosition().y() / mm);
-        analysisManager->FillNtupleDColumn(0, 8, hit->GetPosition().z() / mm);
-        analysisManager->FillNtupleDColumn(0, 9, hit->GetTime() / ns);
-        analysisManager->FillNtupleDColumn(0, 10, hit->GetKineticEnergy() / MeV);
-        analysisManager->FillNtupleDColumn(0, 11, hit->GetEnergyDeposit() / MeV);
-
-        // --- [수정] 확장된 정보 채우기 ---
-        analysisManager->FillNtupleIColumn(0, 12, hit->GetPDGID());
-        analysisManager->FillNtupleDColumn(0, 13, hit->GetPx() / MeV);
-        analysisManager->FillNtupleDColumn(0, 14, hit->GetPy() / MeV);
-        analysisManager->FillNtupleDColumn(0, 15, hit->GetPz() / MeV);
-        analysisManager->FillNtupleDColumn(0, 16, hit->GetEnergy() / MeV);
-        // ------------------------------------
-
-        analysisManager->AddNtupleRow(0);
-      }
+  auto writer = OutputWriter::ForThisThread();
+  if (!writer->IsOpen()) return;
+  // 재개한 런에서 이미 기록된 이벤트는 PrimaryGeneratorAction이 비워 두었으므로 아무것도 하지 않습니다.
+  if (Checkpoint::Completed().Contains(event->GetEventID())) return;
+
+  const G4double cpuTime = fSlowEvents->EndOfEvent(event, fSummary);
+  if (OnlineHistograms::IsActive()) OnlineHistograms::FillEventTime(cpuTime);
+
+  auto hce = event->GetHCofThisEvent();
+  if (!hce) return;
+
+  if (fLSHitsCollectionID < 0) {
+    fLSHitsCollectionID = G4SDManager::GetSDMpointer()->GetCollectionID("LSHitsCollection");
+  }
+  if (fPMTHitsCollectionID < 0) {
+    fPMTHitsCollectionID = G4SDManager::GetSDMpointer()->GetCollectionID("PMTHitsCollection");
+  }
+  auto lsHitsCollection = (fLSHitsCollectionID >= 0) ? static_cast<LSHitsCollection*>(hce->GetHC(fLSHitsCollectionID)) : nullptr;
+  auto pmtHitsCollection = (fPMTHitsCollectionID >= 0) ? static_cast<PMTHitsCollection*>(hce->GetHC(fPMTHitsCollectionID)) : nullptr;
+  const size_t nLSHits = lsHitsCollection ? lsHitsCollection->entries() : 0;
+  const size_t nPMTHits = pmtHitsCollection ? pmtHitsCollection->entries() : 0;
+  ProgressMonitor::AddHits(static_cast<G4long>(nLSHits + nPMTHits));
+
+  // --- 요약: 볼륨별 에너지 증착 ---
+  EventSummaryRecord summary = fSummary;
+  fSegmentEdep.assign(fSegmentEdep.size(), 0.);
+  for (size_t i = 0; i < nLSHits; ++i) {
+    auto hit = (*lsHitsCollection)[i];
+    const G4double edep = hit->GetEnergyDeposit() / MeV;
+    summary.edepTotal += edep;
+    if (hit->GetVolumeName() == "LogicLS_inner") summary.edepGdLS += edep;
+    else if (hit->GetVolumeName() == "LogicLS_outer") summary.edepLS += edep;
+
+    const G4int segment = hit->GetSegmentID();
+    if (segment < 0) continue;
+    if (static_cast<size_t>(segment) >= fSegmentEdep.size()) fSegmentEdep.resize(segment + 1, 0.);
+    fSegmentEdep[segment] += edep;
+  }
+
+  // --- 요약: 광전자 수 ---
+  fChannelPE.assign(fChannelPE.size(), 0);
+  for (size_t i = 0; i < nPMTHits; ++i) {
+    auto pmtHit = (*pmtHitsCollection)[i];
+    const size_t channel = static_cast<size_t>(pmtHit->GetSegmentID() * 2 + pmtHit->GetPMTID());
+    if (channel >= fChannelPE.size()) fChannelPE.resize(channel + 1, 0);
+    ++fChannelPE[channel];
+  }
+  summary.nPE = static_cast<G4int>(nPMTHits);
+  summary.nPMTsHit = static_cast<G4int>(std::count_if(fChannelPE.begin(), fChannelPE.end(), [](G4int pe) { return pe > 0; }));
+
+  // 거절된 이벤트는 레코드를 만들지 않습니다. 체크포인트가 켜져 있으면 완료 표시만 넘깁니다.
+  if (!fTrigger->Accept(summary, fChannelPE)) {
+    if (writer->IsCheckpointing()) {
+      auto marker = std::make_unique<EventRecord>();
+      marker->eventID = event->GetEventID();
+      marker->accepted = false;
+      writer->Submit(std::move(marker));
     }
+    return;
+  }
+
+  const G4bool histograms = OnlineHistograms::IsActive();
+  if (histograms) OnlineHistograms::FillEvent(summary, fSegmentEdep);
+
+  auto record = std::make_unique<EventRecord>();
+  record->eventID = event->GetEventID();
+  record->summary = summary;
+
+  // --- LS 데이터 처리 (LSHitsCollection) ---
+  record->lsHits.resize(nLSHits);
+  for (size_t i = 0; i < nLSHits; ++i) {
+    auto hit = (*lsHitsCollection)[i];
+    LSHitRecord& row = record->lsHits[i];
+
+    // --- 기본 정보 ---
+    row.trackID = hit->GetTrackID();
+    row.parentID = hit->GetParentID();
+    row.particleName = hit->GetParticleName();
+    row.processName = hit->GetProcessName();
+    row.volumeName = hit->GetVolumeName();
+    row.x = hit->GetPosition().x() / mm;
+    row.y = hit->GetPosition().y() / mm;
+    row.z = hit->GetPosition().z() / mm;
+    row.time = hit->GetTime() / ns;
+    row.kineticEnergy = hit->GetKineticEnergy() / MeV;
+    row.energyDeposit = hit->GetEnergyDeposit() / MeV;
+
+    // --- 확장된 정보 ---
+    row.pdgID = hit->GetPDGID();
+    row.px = hit->GetPx() / MeV;
+    row.py = hit->GetPy() / MeV;
+    row.pz = hit->GetPz() / MeV;
+    row.energy = hit->GetEnergy() / MeV;
+    row.weight = hit->GetWeight();
+
+    if (histograms) OnlineHistograms::FillHit(row.kineticEnergy, row.weight);
   }
 
   // --- PMT 데이터 처리 (PMTHitsCollection) ---
-  // (이 부분은 변경 없음)
-  G4int pmtHcID = G4SDManager::GetSDMpointer()->GetCollectionID("PMTHitsCollection");
-  if (pmtHcID >= 0) {
-    auto pmtHitsCollection = static_cast<PMTHitsCollection*>(event->GetHCofThisEvent()->GetHC(pmtHcID));
-    if (pmtHitsCollection && pmtHitsCollection->entries() > 0) {
-      for (size_t i = 0; i < pmtHitsCollection->entries(); ++i) {
-        auto pmtHit = (*pmtHitsCollection)[i];
-        analysisManager->FillNtupleIColumn(1, 0, eventID);
-        analysisManager->FillNtupleIColumn(1, 1, pmtHit->GetSegmentID());
-        analysisManager->FillNtupleIColumn(1, 2, pmtHit->GetPMTID());
-        analysisManager->FillNtupleDColumn(1, 3, pmtHit->GetTime() / ns); // 단위 적용
-        analysisManager->AddNtupleRow(1);
-      }
-    }
+  record->pmtHits.resize(nPMTHits);
+  for (size_t i = 0; i < nPMTHits; ++i) {
+    auto pmtHit = (*pmtHitsCollection)[i];
+    PMTHitRecord& row = record->pmtHits[i];
+    row.segmentID = pmtHit->GetSegmentID();
+    row.pmtID = pmtHit->GetPMTID();
+    row.time = pmtHit->GetTime(); // PMTSD에서 이미 ns 단위로 저장
   }
+
+  writer->Submit(std::move(record));
 }
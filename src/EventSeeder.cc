@@ -0,0 +1,149 @@
+#include "EventSeeder.hh"
+
+#include "G4Event.hh"
+#include "G4GenericMessenger.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
+#include "G4UImanager.hh"
+#include "Randomize.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+std::atomic<G4bool> enabled(false);
+std::atomic<G4long> masterSeed(0);
+// replayEvent 도중에만 0 이상이며, 실제 ID 대신 이 값으로 시드를 만듭니다.
+std::atomic<G4int> replayRunID(-1);
+std::atomic<G4int> replayEventID(-1);
+
+std::uint64_t SplitMix64(std::uint64_t& state)
+{
+  std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+}
+
+EventSeeder::EventSeeder()
+{
+  masterSeed = G4Random::getTheSeed();
+  DefineCommands();
+}
+
+EventSeeder::~EventSeeder() {}
+
+void EventSeeder::DefineCommands()
+{
+  fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/random/", "Event-reproducible seeding");
+  auto& enableCmd = fMessenger->DeclareMethod("eventSeeding", &EventSeeder::SetEnabled,
+      "Seed every event from (master seed, run ID, event ID) instead of the seed queue");
+  enableCmd.SetToBeBroadcasted(false);
+  auto& seedCmd = fMessenger->DeclareMethod("masterSeed", &EventSeeder::SetMasterSeed,
+      "Master seed the event seeds are derived from");
+  seedCmd.SetToBeBroadcasted(false);
+  auto& replayCmd = fMessenger->DeclareMethod("replayEvent", &EventSeeder::ReplayEvent,
+      "Rebuild one event with full tracking verbosity: <eventID> [runID]");
+  replayCmd.SetToBeBroadcasted(false);
+  auto& stateCmd = fMessenger->DeclareMethod("replayState", &EventSeeder::ReplayState,
+      "Rebuild one event from an engine state dumped by /myApp/slowEvents (sequential mode only)");
+  stateCmd.SetToBeBroadcasted(false);
+}
+
+void EventSeeder::SetEnabled(G4bool value)
+{
+  enabled = value;
+}
+
+void EventSeeder::SetMasterSeed(G4long seed)
+{
+  masterSeed = seed;
+}
+
+G4bool EventSeeder::IsEnabled()
+{
+  return enabled;
+}
+
+void EventSeeder::Reseed(const G4Event* event)
+{
+  if (!enabled) return;
+
+  G4int runID = replayRunID;
+  G4int eventID = replayEventID;
+  if (eventID < 0) {
+    const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+    runID = run ? run->GetRunID() : 0;
+    eventID = event->GetEventID();
+  }
+
+  std::uint64_t state = static_cast<std::uint64_t>(masterSeed.load());
+  state ^= SplitMix64(state) + (static_cast<std::uint64_t>(runID) << 32) + static_cast<std::uint32_t>(eventID);
+  // 엔진이 받아들이는 양의 31비트 시드 두 개 (0으로 끝나는 배열)
+  long seeds[3] = {static_cast<long>(SplitMix64(state) % 2147483646ULL) + 1,
+                   static_cast<long>(SplitMix64(state) % 2147483646ULL) + 1, 0};
+  G4Random::setTheSeeds(seeds, -1);
+}
+
+void EventSeeder::ReplayEvent(const G4String& args)
+{
+  std::istringstream is(args);
+  G4int eventID = -1;
+  G4int runID = 0;
+  is >> eventID >> runID;
+  if (eventID < 0) {
+    G4cout << "### /myApp/random/replayEvent: expected <eventID> [runID], got \"" << args << "\"" << G4endl;
+    return;
+  }
+
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  const G4String fileName = UImanager->GetCurrentValues("/myApp/output/fileName");
+  const G4String trackingVerbose = UImanager->GetCurrentValues("/tracking/verbose");
+  const G4bool wasEnabled = enabled;
+
+  G4cout << "### Replaying event " << eventID << " of run " << runID << " (master seed " << masterSeed.load() << ")"
+         << G4endl;
+  enabled = true;
+  replayRunID = runID;
+  replayEventID = eventID;
+  UImanager->ApplyCommand("/myApp/output/fileName " + fileName + "_replay" + std::to_string(eventID));
+  UImanager->ApplyCommand("/tracking/verbose 1");
+  UImanager->ApplyCommand("/run/beamOn 1");
+  UImanager->ApplyCommand("/tracking/verbose " + trackingVerbose);
+  UImanager->ApplyCommand("/myApp/output/fileName " + fileName);
+  replayRunID = -1;
+  replayEventID = -1;
+  enabled = wasEnabled;
+}
+
+void EventSeeder::ReplayState(const G4String& file)
+{
+  // MT 워커는 이벤트마다 마스터의 시드 큐에서 다시 시드하므로 되살린 상태가 쓰이지 않습니다.
+  if (G4Threading::IsMultithreadedApplication()) {
+    G4cout << "### /myApp/random/replayState: needs the sequential run manager (-r serial)." << G4endl;
+    return;
+  }
+  std::ifstream in(file);
+  if (!in) {
+    G4cout << "### /myApp/random/replayState: cannot read " << file << G4endl;
+    return;
+  }
+
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  const G4String fileName = UImanager->GetCurrentValues("/myApp/output/fileName");
+  const G4bool wasEnabled = enabled;
+
+  G4cout << "### Replaying the event stored in " << file << G4endl;
+  // 저장된 상태는 1차 입자를 만들기 직전의 것이므로 이벤트 시드 모드가 다시 시드하면 안 됩니다.
+  enabled = false;
+  G4Random::restoreFullState(in);
+  UImanager->ApplyCommand("/myApp/output/fileName " + std::filesystem::path(file).replace_extension().string() + "_replay");
+  UImanager->ApplyCommand("/run/beamOn 1");
+  UImanager->ApplyCommand("/myApp/output/fileName " + fileName);
+  enabled = wasEnabled;
+}
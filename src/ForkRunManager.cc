@@ -0,0 +1,97 @@
+#include "ForkRunManager.hh"
+#include "OutputWriter.hh"
+#include "StartupTimer.hh"
+
+#include "G4UImanager.hh"
+#include "Randomize.hh"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+ForkRunManager::ForkRunManager()
+: G4RunManager(),
+  fChildIndex(-1),
+  fFirstEventID(0),
+  fEventOffset(0),
+  fSetupOnly(false)
+{}
+
+ForkRunManager::~ForkRunManager() {}
+
+void ForkRunManager::BeamOn(G4int n_event, const char* macroFile, G4int n_select)
+{
+  if (fSetupOnly) {
+    // 매크로에서 부모가 이벤트를 돌리면 fork 전에 -n과 별개로 순차 실행이 한 번 더 일어납니다.
+    G4ExceptionDescription message;
+    message << "/run/beamOn " << n_event << " ignored: in fork mode the macro must only set up the run;"
+            << " the events are given with -n.";
+    G4Exception("ForkRunManager::BeamOn()", "BeamOnInSetupMacro", JustWarning, message);
+    return;
+  }
+  G4RunManager::BeamOn(n_event, macroFile, n_select);
+}
+
+G4Event* ForkRunManager::GenerateEvent(G4int i_event)
+{
+  // 자식마다 다른 이벤트 ID 구간을 쓰도록 합니다 (출력, 체크포인트, 병합 색인이 모두 이 ID를 씁니다).
+  return G4RunManager::GenerateEvent(i_event + fEventOffset);
+}
+
+G4int ForkRunManager::RunForked(G4int nProcesses, G4int nEvents)
+{
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  fSetupOnly = false;
+
+  // 빈 런으로 물리 테이블과 HP 데이터까지 부모에서 만들어 두어야 자식들이 그대로 공유합니다.
+  BeamOn(0);
+  StartupTimer::Print();
+
+  const G4String baseName = UImanager->GetCurrentValues("/myApp/output/fileName");
+
+  // G4MTRunManager가 워커에 시드를 나눠 주는 것과 같은 방식으로 부모 엔진에서 자식의 시드를 뽑습니다.
+  std::vector<std::array<long, 3>> seeds(nProcesses);
+  for (auto& seed : seeds) {
+    seed = {static_cast<long>(100000000L * G4UniformRand()), static_cast<long>(100000000L * G4UniformRand()), 0};
+  }
+
+  // 버퍼에 남은 출력이 자식마다 한 번씩 더 찍히지 않도록 비웁니다.
+  G4cout << "### Fork: " << nEvents << " events in " << nProcesses << " processes" << G4endl;
+  std::cout.flush();
+  std::fflush(nullptr);
+
+  std::vector<pid_t> children;
+  for (G4int k = 0; k < nProcesses; ++k) {
+    const auto first = static_cast<G4int>(static_cast<G4long>(nEvents) * k / nProcesses);
+    const auto last = static_cast<G4int>(static_cast<G4long>(nEvents) * (k + 1) / nProcesses);
+    const pid_t pid = fork();
+    if (pid < 0) {
+      G4cerr << "ForkRunManager: fork() failed for process " << k << G4endl;
+      break;
+    }
+    if (pid == 0) {
+      fChildIndex = k;
+      fEventOffset = fFirstEventID + first;
+      G4Random::setTheSeeds(seeds[k].data(), -1);
+      UImanager->ApplyCommand("/myApp/output/fileName " + baseName + "_p" + std::to_string(k));
+      BeamOn(last - first);
+      // 부모가 실패한 자식을 셀 수 있도록, 몫을 다 처리하고 출력을 제대로 쓴 경우에만 0을 돌려줍니다.
+      const G4bool complete = !runAborted && numberOfEventProcessed == last - first;
+      return (complete && !OutputWriter::Instance()->HasOpenFailed()) ? 0 : 1;
+    }
+    children.push_back(pid);
+  }
+
+  G4int failed = nProcesses - static_cast<G4int>(children.size());
+  for (const pid_t pid : children) {
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) ++failed;
+  }
+  G4cout << "### Fork: " << nProcesses - failed << " of " << nProcesses << " processes finished" << G4endl;
+  return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+#include "GdCaptureBiasingOperator.hh"
+
+#include "G4BiasingProcessInterface.hh"
+#include "G4BiasingProcessSharedData.hh"
+#include "G4BOptnChangeCrossSection.hh"
+#include "G4GenericMessenger.hh"
+#include "G4Neutron.hh"
+#include "G4ProcessManager.hh"
+#include "G4Track.hh"
+
+GdCaptureBiasingOperator::GdCaptureBiasingOperator()
+  : G4VBiasingOperator("GdCaptureBiasingOperator"),
+    fNeutron(G4Neutron::Definition()),
+    fEnabled(false),
+    fFactor(10.)
+{
+    DefineCommands();
+}
+
+GdCaptureBiasingOperator::~GdCaptureBiasingOperator() {}
+
+void GdCaptureBiasingOperator::DefineCommands() {
+    fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/bias/gdCapture/", "Neutron capture biasing in Gd-LS");
+    fMessenger->DeclareProperty("enable", fEnabled, "Enable capture cross-section biasing in LogicLS_inner");
+    fMessenger->DeclareProperty("factor", fFactor, "Multiply the nCapture cross section in Gd-LS by this factor");
+}
+
+void GdCaptureBiasingOperator::StartRun() {
+    // 중성자의 nCapture를 감싼 G4BiasingProcessInterface마다 단면적 변경 operation을 하나씩 만듭니다.
+    if (!fOperations.empty()) return;
+    const G4BiasingProcessSharedData* sharedData =
+        G4BiasingProcessInterface::GetSharedData(fNeutron->GetProcessManager());
+    if (!sharedData) return;
+    for (const G4BiasingProcessInterface* wrapper : sharedData->GetPhysicsBiasingProcessInterfaces()) {
+        const G4String name = "XSchange-" + wrapper->GetWrappedProcess()->GetProcessName();
+        fOperations[wrapper] = std::make_unique<G4BOptnChangeCrossSection>(name);
+    }
+}
+
+G4VBiasingOperation* GdCaptureBiasingOperator::ProposeOccurenceBiasingOperation(
+    const G4Track* track, const G4BiasingProcessInterface* callingProcess) {
+    if (!fEnabled || fFactor <= 0. || track->GetDefinition() != fNeutron) return nullptr;
+
+    auto it = fOperations.find(callingProcess);
+    if (it == fOperations.end()) return nullptr;
+    G4BOptnChangeCrossSection* operation = it->second.get();
+
+    // 원래(analog) 단면적. 이 볼륨에서 포획이 불가능하면 biasing 하지 않습니다.
+    const G4double analogInteractionLength = callingProcess->GetWrappedProcess()->GetCurrentInteractionLength();
+    if (analogInteractionLength > DBL_MAX / 10.) return nullptr;
+    const G4double biasedXS = fFactor / analogInteractionLength;
+
+    // 예제 GB01과 같은 방식: 새 스텝이면 상호작용 길이를 다시 뽑고, 계속되는 스텝이면 남은 길이를 갱신합니다.
+    G4VBiasingOperation* previousOperation = callingProcess->GetPreviousOccurenceBiasingOperation();
+    if (previousOperation == nullptr || previousOperation != operation || operation->GetInteractionOccured()) {
+        operation->SetBiasedCrossSection(biasedXS);
+        operation->Sample();
+    } else {
+        operation->UpdateForStep(callingProcess->GetPreviousStepSize());
+        operation->SetBiasedCrossSection(biasedXS);
+        operation->UpdateForStep(0.0);
+    }
+    return operation;
+}
+
+void GdCaptureBiasingOperator::OperationApplied(const G4BiasingProcessInterface* callingProcess,
+                                                G4BiasingAppliedCase /*biasingCase*/,
+                                                G4VBiasingOperation* occurenceOperationApplied,
+                                                G4double /*weightForOccurenceInteraction*/,
+                                                G4VBiasingOperation* /*finalStateOperationApplied*/,
+                                                const G4VParticleChange* /*particleChangeProduced*/) {
+    auto it = fOperations.find(callingProcess);
+    if (it == fOperations.end()) return;
+    if (it->second.get() == occurenceOperationApplied) it->second->SetInteractionOccured();
+}
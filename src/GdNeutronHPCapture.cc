@@ -13,6 +13,7 @@
 #include "GdNeutronHPCaptureFS.hh"
 #include "ANNRIGd_GdNCaptureGammaGenerator.hh"
 #include "ANNRIGd_GeneratorConfigurator.hh"
+#include "StartupTimer.hh"
 
 GdNeutronHPCapture::GdNeutronHPCapture() 
   : G4NeutronHPCapture(),
@@ -42,6 +43,7 @@ void GdNeutronHPCapture::DefineCommands() {
 
 void GdNeutronHPCapture::InitializeGenerator() {
     if (fIsGeneratorInitialized) return;
+    StartupTimer::Scope timer("ANNRI-Gd tables");
     const char* dataDirEnv = getenv("GD_CAPTURE_DATA_DIR");
     if (!dataDirEnv) {
         G4Exception("GdNeutronHPCapture::InitializeGenerator()", "FatalError", FatalException, "Environment variable GD_CAPTURE_DATA_DIR is not set!");
@@ -57,6 +59,13 @@ void GdNeutronHPCapture::InitializeGenerator() {
     if (fVerboseLevel > 0) G4cout << "GdNeutronHPCapture: ANNRI-Gd Generator Initialized." << G4endl;
 }
 
+void GdNeutronHPCapture::BuildPhysicsTable(const G4ParticleDefinition& particle)
+{
+    // G4NDL 포획 데이터는 여기서 읽힙니다.
+    StartupTimer::Scope timer("HP data");
+    G4NeutronHPCapture::BuildPhysicsTable(particle);
+}
+
 G4HadFinalState* GdNeutronHPCapture::ApplyYourself(const G4HadProjectile& aTrack, G4Nucleus& aTargetNucleus)
 {
     if (aTargetNucleus.GetZ_asInt() == 64) {
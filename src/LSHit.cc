@@ -7,7 +7,10 @@ LSHit::LSHit()
   fTrackID(0), fParentID(0),
   fParticleName(""), fProcessName(""), fVolumeName(""),
   fPosition(0,0,0), fTime(0.),
-  fKineticEnergy(0.), fEnergyDeposit(0.)
+  fKineticEnergy(0.), fEnergyDeposit(0.),
+  fPDGID(0), fPx(0.), fPy(0.), fPz(0.), fEnergy(0.),
+  fWeight(1.),
+  fSegmentID(-1)
 {}
 
 LSHit::~LSHit()
@@ -5,6 +5,7 @@
 #include "G4VProcess.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4SDManager.hh"
+#include "G4VTouchable.hh"
 
 LSSD::LSSD(const G4String& name)
 : G4VSensitiveDetector(name), fHitsCollection(nullptr)
@@ -52,6 +53,10 @@ G4bool LSSD::ProcessHits(G4Step* aStep, G4TouchableHistory* /*ROhist*/)
   newHit->SetPDGID(track->GetDefinition()->GetPDGEncoding());
   newHit->SetMomentum(preStepPoint->GetMomentum());
   newHit->SetEnergy(preStepPoint->GetTotalEnergy());
+  newHit->SetWeight(preStepPoint->GetWeight());
+  // 세그먼트는 월드 바로 아래(깊이 1)에 놓여 있습니다.
+  const G4VTouchable* touchable = preStepPoint->GetTouchable();
+  newHit->SetSegmentID(touchable->GetCopyNumber(touchable->GetHistoryDepth() - 1));
   // ------------------------------------
 
   fHitsCollection->insert(newHit);
@@ -26,6 +26,21 @@
 // 포획 (Capture)
 #include "G4NeutronCaptureProcess.hh"
 #include "GdNeutronHPCapture.hh" // 우리의 커스텀 모델
+#include "StartupTimer.hh"
+
+namespace {
+// HP 단면적/모델 데이터(G4NDL)는 BuildPhysicsTable에서 읽히므로, 그 시간을 시작 비용의 "HP data" 단계로 잽니다.
+template <typename HPComponent>
+class TimedHP : public HPComponent
+{
+public:
+    void BuildPhysicsTable(const G4ParticleDefinition& particle) override
+    {
+        StartupTimer::Scope timer("HP data");
+        HPComponent::BuildPhysicsTable(particle);
+    }
+};
+}
 
 MyHadronPhysics::MyHadronPhysics(G4int verbose)
   : G4VPhysicsConstructor("MyHadronPhysics")
@@ -65,22 +80,22 @@ void MyHadronPhysics::ConstructProcess()
 
     // 3. 탄성 산란 (Elastic Scattering) 프로세스 추가
     auto elasticProcess = new G4HadronElasticProcess();
-    elasticProcess->AddDataSet(new G4NeutronHPElasticData());
-    elasticProcess->RegisterMe(new G4NeutronHPElastic());
+    elasticProcess->AddDataSet(new TimedHP<G4NeutronHPElasticData>());
+    elasticProcess->RegisterMe(new TimedHP<G4NeutronHPElastic>());
     pManager->AddDiscreteProcess(elasticProcess);
     G4cout << "MyHadronPhysics: G4NeutronHPElastic registered." << G4endl;
 
     // 4. 비탄성 산란 (Inelastic Scattering) 프로세스 추가
     auto inelasticProcess = new G4HadronInelasticProcess("neutronInelastic");
-    inelasticProcess->AddDataSet(new G4NeutronHPInelasticData());
-    inelasticProcess->RegisterMe(new G4NeutronHPInelastic());
+    inelasticProcess->AddDataSet(new TimedHP<G4NeutronHPInelasticData>());
+    inelasticProcess->RegisterMe(new TimedHP<G4NeutronHPInelastic>());
     pManager->AddDiscreteProcess(inelasticProcess);
     G4cout << "MyHadronPhysics: G4NeutronHPInelastic registered." << G4endl;
 
     // 5. 핵분열 (Fission) 프로세스 추가
     auto fissionProcess = new G4NeutronFissionProcess();
-    fissionProcess->AddDataSet(new G4NeutronHPFissionData());
-    fissionProcess->RegisterMe(new G4NeutronHPFission());
+    fissionProcess->AddDataSet(new TimedHP<G4NeutronHPFissionData>());
+    fissionProcess->RegisterMe(new TimedHP<G4NeutronHPFission>());
     pManager->AddDiscreteProcess(fissionProcess);
     G4cout << "MyHadronPhysics: G4NeutronHPFission registered." << G4endl;
 
@@ -1,11 +1,15 @@
 #include "MyShieldingPhysList.hh"
 #include "MyHadronPhysics.hh" // 사용자 정의 강입자 물리
+#include "StartupTimer.hh"
 
 // Geant4 표준 물리 리스트 부품들
 #include "G4DecayPhysics.hh"
 #include "G4RadioactiveDecayPhysics.hh"
 #include "G4EmStandardPhysics_option4.hh" // 정밀한 EM 물리 모델
 #include "G4OpticalPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4StepLimiterPhysics.hh"
+#include "G4GenericBiasingPhysics.hh"
 #include "G4SystemOfUnits.hh"
 
 MyShieldingPhysList::MyShieldingPhysList(G4int verbose)
@@ -30,6 +34,21 @@ MyShieldingPhysList::MyShieldingPhysList(G4int verbose)
     // 5. 강입자 물리 (Hadronic Physics) - ANNRI-Gd 모델이 포함된 우리 커스텀 모듈
     RegisterPhysics(new MyHadronPhysics(verbose));
 
+    // 6. Fast Simulation - 세그먼트 광학 모델(SegmentOpticalModel)이 광학 광자를 넘겨받을 수 있도록 활성화
+    auto fastSimulationPhysics = new G4FastSimulationPhysics();
+    fastSimulationPhysics->ActivateFastSimulation("opticalphoton");
+    RegisterPhysics(fastSimulationPhysics);
+
+    // 7. 영역별 G4UserLimits(최대 시간, 최소 운동 에너지)를 적용하는 G4UserSpecialCuts 등록
+    //    영역별 컷과 제한값은 DetectorConstruction의 /myApp/region/ 명령어로 설정합니다.
+    RegisterPhysics(new G4StepLimiterPhysics());
+
+    // 8. 중성자 포획(nCapture)을 G4BiasingProcessInterface로 감쌈 - 강입자 물리보다 뒤에 등록해야 합니다.
+    //    실제 biasing은 Gd-LS에 붙은 GdCaptureBiasingOperator가 켜져 있을 때만 일어납니다.
+    auto biasingPhysics = new G4GenericBiasingPhysics();
+    biasingPhysics->PhysicsBias("neutron", {"nCapture"});
+    RegisterPhysics(biasingPhysics);
+
     // --- [수정] 정의된 컷 값을 Geant4 커널에 실제로 적용하라는 명령 추가 ---
     SetCuts();
 }
@@ -46,5 +65,6 @@ void MyShieldingPhysList::ConstructParticle()
 void MyShieldingPhysList::ConstructProcess()
 {
     // 각 물리 부분들이 입자에 맞는 물리 프로세스를 등록합니다.
+    StartupTimer::Scope timer("physics list");
     G4VModularPhysicsList::ConstructProcess();
 }
@@ -0,0 +1,55 @@
+#include "OnlineHistograms.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4AnalysisManager.hh"
+
+void OnlineHistograms::Book()
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  analysisManager->SetVerboseLevel(0);
+
+  // 생성 순서가 곧 H1 / H2 enum의 ID입니다.
+  analysisManager->CreateH1("h_total_edep", "Total energy deposit per event;Energy (MeV);Entries", 600, 0., 12.);
+  analysisManager->CreateH1("h_kinetic", "Kinetic energy of particles creating hits;Kinetic Energy (MeV);Entries",
+                            500, 0., 10.);
+  analysisManager->CreateH1("h_capture_time", "First neutron capture time;Time (us);Entries", 500, 0., 500.);
+  analysisManager->CreateH1("h_capture_gamma_energy", "Summed capture gamma energy;Energy (MeV);Entries",
+                            500, 0., 10.);
+  analysisManager->CreateH1("h_npe", "Photoelectrons per event;N_{PE};Entries", 500, 0., 5000.);
+  // 느린 이벤트는 중앙값의 수천 배까지 걸리므로 1 us ~ 10^4 s를 로그 눈금으로 나눕니다.
+  analysisManager->CreateH1("h_event_cpu_time", "CPU time per event;Time (s);Entries", 200, 1e-6, 1e4,
+                            "none", "none", "log");
+
+  const G4int nSegments = DetectorConstruction::kNx * DetectorConstruction::kNy;
+  analysisManager->CreateH2("h_segment_edep", "Energy deposit per segment;Segment ID;Energy (MeV)",
+                            nSegments, -0.5, nSegments - 0.5, 240, 0., 12.);
+}
+
+G4bool OnlineHistograms::IsActive()
+{
+  return G4AnalysisManager::Instance()->IsOpenFile();
+}
+
+void OnlineHistograms::FillHit(G4double kineticEnergy, G4double weight)
+{
+  G4AnalysisManager::Instance()->FillH1(kHitKineticEnergy, kineticEnergy, weight);
+}
+
+void OnlineHistograms::FillEvent(const EventSummaryRecord& summary, const std::vector<G4double>& segmentEdep)
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  if (summary.edepTotal > 0.) analysisManager->FillH1(kEdepTotal, summary.edepTotal);
+  if (summary.nCaptures > 0) {
+    analysisManager->FillH1(kCaptureTime, summary.captureTime / 1000., summary.captureWeight);
+    analysisManager->FillH1(kCaptureGammaEnergy, summary.captureGammaEnergy, summary.captureWeight);
+  }
+  analysisManager->FillH1(kNPE, summary.nPE);
+  for (std::size_t segment = 0; segment < segmentEdep.size(); ++segment) {
+    if (segmentEdep[segment] > 0.) analysisManager->FillH2(kSegmentEdep, segment, segmentEdep[segment]);
+  }
+}
+
+void OnlineHistograms::FillEventTime(G4double cpuSeconds)
+{
+  G4AnalysisManager::Instance()->FillH1(kEventCPUTime, cpuSeconds);
+}
@@ -0,0 +1,597 @@
+#include "OutputWriter.hh"
+
+#include "Compression.h"
+#include "TFile.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+namespace {
+// 한 번에 꺼내 쓰는 최대 레코드 수
+constexpr std::size_t kDrainBatch = 256;
+
+G4ThreadLocal OutputWriter* threadWriter = nullptr;
+
+std::atomic<G4long> bytesWritten(0);
+
+// ROOT leaflist의 타입 문자 (0이면 객체 branch)
+template <typename T> char LeafType() { return 0; }
+template <> char LeafType<Int_t>() { return 'I'; }
+template <> char LeafType<UShort_t>() { return 's'; }
+template <> char LeafType<UChar_t>() { return 'b'; }
+template <> char LeafType<Float_t>() { return 'F'; }
+template <> char LeafType<Double_t>() { return 'D'; }
+
+// 저장 타입 T의 컬럼. 행 스키마에서는 fValue 하나를, vector 스키마에서는 fValues를 branch 버퍼로 씁니다.
+template <typename Record, typename T>
+class TypedColumn : public OutputColumn<Record>
+{
+public:
+  using Getter = T (*)(const Record&);
+
+  TypedColumn(const char* name, Getter getter) : fName(name), fGetter(getter), fValue() {}
+
+  void Book(TTree* tree, G4bool perEvent) override
+  {
+    const char leaf = LeafType<T>();
+    if (perEvent) tree->Branch(fName.c_str(), &fValues);
+    else if (leaf) tree->Branch(fName.c_str(), &fValue, (fName + "/" + leaf).c_str());
+    else tree->Branch(fName.c_str(), &fValue);
+  }
+  void Set(const Record& record) override { fValue = fGetter(record); }
+  void Append(const Record& record) override { fValues.push_back(fGetter(record)); }
+  // clear()는 용량을 유지하므로 이벤트마다 다시 할당하지 않습니다.
+  void Clear() override { fValues.clear(); }
+
+private:
+  std::string fName;
+  Getter fGetter;
+  T fValue;
+  std::vector<T> fValues;
+};
+
+template <typename T, typename Record>
+void AddColumn(std::vector<std::unique_ptr<OutputColumn<Record>>>& columns, const char* name,
+               T (*getter)(const Record&))
+{
+  columns.push_back(std::make_unique<TypedColumn<Record, T>>(name, getter));
+}
+
+// LS 볼륨 이름을 1바이트 코드로 줄입니다. 0: 기타, 1: Gd-LS(LogicLS_inner), 2: LS(LogicLS_outer)
+UChar_t VolumeCode(const std::string& volumeName)
+{
+  if (volumeName == "LogicLS_inner") return 1;
+  if (volumeName == "LogicLS_outer") return 2;
+  return 0;
+}
+
+using LSColumns = std::vector<std::unique_ptr<OutputColumn<LSHitRecord>>>;
+using PMTColumns = std::vector<std::unique_ptr<OutputColumn<PMTHitRecord>>>;
+
+LSColumns MakeLSHitColumns(OutputWriter::Profile profile)
+{
+  using H = LSHitRecord;
+  LSColumns c;
+  if (profile == OutputWriter::Profile::kFull) {
+    // 숫자 컬럼의 이름과 순서는 G4AnalysisManager가 만들던 것을 따르지만, 스키마는 같지 않습니다.
+    // particleName, processName, volumeName은 char leaf가 아닌 std::string 객체 branch이고,
+    // Hits 트리에는 첫 branch로 eventID가, 끝에 weight가 더해졌습니다.
+    AddColumn<Int_t>(c, "trackID", +[](const H& h) { return h.trackID; });
+    AddColumn<Int_t>(c, "parentID", +[](const H& h) { return h.parentID; });
+    AddColumn<std::string>(c, "particleName", +[](const H& h) { return h.particleName; });
+    AddColumn<std::string>(c, "processName", +[](const H& h) { return h.processName; });
+    AddColumn<std::string>(c, "volumeName", +[](const H& h) { return h.volumeName; });
+    AddColumn<Double_t>(c, "x_mm", +[](const H& h) { return h.x; });
+    AddColumn<Double_t>(c, "y_mm", +[](const H& h) { return h.y; });
+    AddColumn<Double_t>(c, "z_mm", +[](const H& h) { return h.z; });
+    AddColumn<Double_t>(c, "time_ns", +[](const H& h) { return h.time; });
+    AddColumn<Double_t>(c, "kineticEnergy_MeV", +[](const H& h) { return h.kineticEnergy; });
+    AddColumn<Double_t>(c, "energyDeposit_MeV", +[](const H& h) { return h.energyDeposit; });
+    AddColumn<Int_t>(c, "pdgID", +[](const H& h) { return h.pdgID; });
+    AddColumn<Double_t>(c, "px_MeV", +[](const H& h) { return h.px; });
+    AddColumn<Double_t>(c, "py_MeV", +[](const H& h) { return h.py; });
+    AddColumn<Double_t>(c, "pz_MeV", +[](const H& h) { return h.pz; });
+    AddColumn<Double_t>(c, "energy_MeV", +[](const H& h) { return h.energy; });
+    AddColumn<Double_t>(c, "weight", +[](const H& h) { return h.weight; });
+    return c;
+  }
+
+  // float의 유효숫자(약 7자리)는 mm 단위 위치, 포획 시간(~100 us)의 0.01 ns 분해능에 충분합니다.
+  const G4bool physics = (profile == OutputWriter::Profile::kPhysics);
+  if (physics) {
+    AddColumn<Int_t>(c, "trackID", +[](const H& h) { return h.trackID; });
+    AddColumn<Int_t>(c, "parentID", +[](const H& h) { return h.parentID; });
+  }
+  AddColumn<Int_t>(c, "pdgID", +[](const H& h) { return h.pdgID; }); // 원자핵 PDG 코드(10자리) 때문에 Int_t가 필요합니다.
+  AddColumn<UChar_t>(c, "volumeID", +[](const H& h) { return VolumeCode(h.volumeName); });
+  AddColumn<Float_t>(c, "x_mm", +[](const H& h) { return static_cast<Float_t>(h.x); });
+  AddColumn<Float_t>(c, "y_mm", +[](const H& h) { return static_cast<Float_t>(h.y); });
+  AddColumn<Float_t>(c, "z_mm", +[](const H& h) { return static_cast<Float_t>(h.z); });
+  AddColumn<Float_t>(c, "time_ns", +[](const H& h) { return static_cast<Float_t>(h.time); });
+  if (physics) {
+    AddColumn<Float_t>(c, "kineticEnergy_MeV", +[](const H& h) { return static_cast<Float_t>(h.kineticEnergy); });
+  }
+  AddColumn<Float_t>(c, "energyDeposit_MeV", +[](const H& h) { return static_cast<Float_t>(h.energyDeposit); });
+  if (physics) {
+    AddColumn<Float_t>(c, "px_MeV", +[](const H& h) { return static_cast<Float_t>(h.px); });
+    AddColumn<Float_t>(c, "py_MeV", +[](const H& h) { return static_cast<Float_t>(h.py); });
+    AddColumn<Float_t>(c, "pz_MeV", +[](const H& h) { return static_cast<Float_t>(h.pz); });
+  }
+  AddColumn<Float_t>(c, "weight", +[](const H& h) { return static_cast<Float_t>(h.weight); });
+  return c;
+}
+
+PMTColumns MakePMTHitColumns(OutputWriter::Profile profile)
+{
+  using H = PMTHitRecord;
+  PMTColumns c;
+  if (profile == OutputWriter::Profile::kFull) {
+    AddColumn<Int_t>(c, "segmentID", +[](const H& h) { return h.segmentID; });
+    AddColumn<Int_t>(c, "pmtID", +[](const H& h) { return h.pmtID; });
+    AddColumn<Double_t>(c, "time_ns", +[](const H& h) { return h.time; });
+  } else {
+    AddColumn<UShort_t>(c, "segmentID", +[](const H& h) { return static_cast<UShort_t>(h.segmentID); });
+    AddColumn<UChar_t>(c, "pmtID", +[](const H& h) { return static_cast<UChar_t>(h.pmtID); });
+    AddColumn<Float_t>(c, "time_ns", +[](const H& h) { return static_cast<Float_t>(h.time); });
+  }
+  return c;
+}
+}
+
+OutputWriter* OutputWriter::Instance()
+{
+  static OutputWriter instance(true);
+  return &instance;
+}
+
+OutputWriter* OutputWriter::ForThisThread()
+{
+  return threadWriter ? threadWriter : Instance();
+}
+
+void OutputWriter::SetThreadWriter(OutputWriter* writer)
+{
+  threadWriter = writer;
+}
+
+G4long OutputWriter::GetBytesWritten()
+{
+  return bytesWritten.load(std::memory_order_relaxed);
+}
+
+OutputWriter::OutputWriter(G4bool asynchronous)
+: fAsynchronous(asynchronous),
+  fLayout(Layout::kRowPerHit),
+  fProfile(Profile::kFull),
+  fOpen(false),
+  fOpenFailed(false),
+  fStopRequested(false),
+  fPending(0),
+  fMaxPending(100000),
+  fPeakPending(0),
+  fEventsWritten(0),
+  fEventsInFile(0),
+  fRollEvents(0),
+  fRollBytes(0),
+  fChunk(0),
+  fRollPending(false),
+  fCheckpointInterval(0),
+  fEventsSinceCheckpoint(0),
+  fTotBytes(0),
+  fZipBytes(0),
+  fFileBytes(0),
+  fFile(nullptr),
+  fHitsTree(nullptr),
+  fPMTHitsTree(nullptr),
+  fEventsTree(nullptr),
+  fEventID(0)
+{}
+
+OutputWriter::~OutputWriter()
+{
+  Close();
+}
+
+void OutputWriter::Open(const G4String& fileName)
+{
+  if (IsOpen()) Close();
+
+  fFileName = fileName;
+  fChunk = 0;
+  fRollPending = false;
+  fTotBytes = 0;
+  fZipBytes = 0;
+  fOpenFailed.store(false, std::memory_order_release);
+  if (!OpenFile()) return;
+  // 이후 ROOT 객체는 쓰기 스레드(동기식이면 소유한 워커 스레드)만 사용합니다.
+
+  fStopRequested.store(false, std::memory_order_relaxed);
+  fPeakPending = 0;
+  fEventsWritten = 0;
+  fOpen.store(true, std::memory_order_release);
+  if (fAsynchronous) fThread = std::thread(&OutputWriter::Run, this);
+}
+
+G4bool OutputWriter::IsRolling() const
+{
+  return fRollEvents > 0 || fRollBytes > 0;
+}
+
+G4String OutputWriter::ChunkFileName() const
+{
+  if (!IsRolling()) return fFileName;
+
+  // <이름>.root -> <이름>_0000.root, <이름>_0001.root, ...
+  G4String stem = fFileName;
+  const G4String extension = ".root";
+  if (stem.size() > extension.size() && stem.compare(stem.size() - extension.size(), extension.size(), extension) == 0) {
+    stem.erase(stem.size() - extension.size());
+  }
+  char suffix[16];
+  std::snprintf(suffix, sizeof(suffix), "_%04d", fChunk);
+  return stem + suffix + extension;
+}
+
+G4bool OutputWriter::OpenFile()
+{
+  // 나눠 쓰는 파일은 완성될 때까지 .part 이름으로 쓰므로, <이름>_NNNN.root가 보이면 이미 닫힌 파일입니다.
+  const G4String path = IsRolling() ? ChunkFileName() + ".part" : ChunkFileName();
+  fFile = TFile::Open(path.c_str(), "RECREATE", "", CompressionSettings());
+  if (!fFile || fFile->IsZombie()) {
+    G4cerr << "### OutputWriter: cannot open " << path << G4endl;
+    fOpenFailed.store(true, std::memory_order_release);
+    delete fFile;
+    fFile = nullptr;
+    return false;
+  }
+  BookTrees();
+  for (auto tree : {fHitsTree, fPMTHitsTree, fEventsTree}) ApplyStorage(tree);
+  fEventsInFile = 0;
+  fFileBytes = 0;
+  return true;
+}
+
+void OutputWriter::CloseFile()
+{
+  if (!fFile) return;
+
+  fFile->cd();
+  for (auto tree : {fHitsTree, fPMTHitsTree, fEventsTree}) {
+    tree->Write();
+    fTotBytes += tree->GetTotBytes();
+    fZipBytes += tree->GetZipBytes();
+  }
+  fFile->Close();
+  bytesWritten.fetch_add(fFile->GetBytesWritten() - fFileBytes, std::memory_order_relaxed);
+  delete fFile;
+  fFile = nullptr;
+  fHitsTree = nullptr;
+  fPMTHitsTree = nullptr;
+  fEventsTree = nullptr;
+
+  if (IsRolling()) {
+    const G4String path = ChunkFileName();
+    std::rename((path + ".part").c_str(), path.c_str());
+    G4cout << "### OutputWriter: " << path << " closed (" << fEventsInFile << " events)." << G4endl;
+  }
+  // 닫힌 파일의 이벤트는 모두 안전하므로 체크포인트에 반영합니다.
+  if (IsCheckpointing()) SaveCheckpoint(false);
+}
+
+void OutputWriter::SetCheckpoint(const G4String& fileName, G4long interval, const Checkpoint& initial)
+{
+  fCheckpointFile = fileName;
+  fCheckpointInterval = interval;
+  fCheckpoint = initial;
+  fEventsSinceCheckpoint = 0;
+}
+
+void OutputWriter::SaveCheckpoint(G4bool autoSave)
+{
+  // AutoSave는 basket과 TTree 헤더, 파일의 키 목록을 디스크에 써서, 이후에 프로그램이 죽어도
+  // 지금까지의 entry를 ROOT가 복구할 수 있게 합니다. 완료 목록은 그 다음에 저장해야 순서가 맞습니다.
+  if (autoSave && fFile) {
+    for (auto tree : {fHitsTree, fPMTHitsTree, fEventsTree}) tree->AutoSave("SaveSelf");
+    fCheckpoint.SetOutputFile(fFile->GetName());
+  }
+  else {
+    fCheckpoint.SetOutputFile(ChunkFileName());
+  }
+  if (!fCheckpoint.Save(fCheckpointFile)) {
+    G4cerr << "### OutputWriter: cannot write checkpoint " << fCheckpointFile << G4endl;
+  }
+  fEventsSinceCheckpoint = 0;
+}
+
+void OutputWriter::RollOver()
+{
+  // 한 이벤트는 항상 한 파일에 들어가도록, 이벤트를 다 쓴 뒤에만 검사합니다.
+  // 바이트 기준은 디스크에 이미 쓰인 basket만 세므로 auto-flush 클러스터 하나만큼 넘칠 수 있습니다.
+  const G4bool full = (fRollEvents > 0 && fEventsInFile >= fRollEvents) ||
+                      (fRollBytes > 0 && fFile->GetBytesWritten() >= fRollBytes);
+  if (!full) return;
+  // 다음 파일은 다음 레코드가 왔을 때 엽니다. 이벤트 수가 나눠떨어져도 빈 파일이 생기지 않습니다.
+  CloseFile();
+  fRollPending = true;
+}
+
+void OutputWriter::BookTrees()
+{
+  fFile->cd();
+  const G4bool perEvent = (fLayout == Layout::kVectorPerEvent);
+  fLSColumns = MakeLSHitColumns(fProfile);
+  fPMTColumns = MakePMTHitColumns(fProfile);
+
+  // vector 스키마는 이벤트당 한 행입니다. 컬럼 이름은 행 스키마와 같고 값만 std::vector입니다.
+  fHitsTree = new TTree("Hits", perEvent ? "Energy deposition hits, one entry per event"
+                                         : "Hit-by-hit energy deposition data");
+  fHitsTree->Branch("eventID", &fEventID, "eventID/I");
+  for (auto& column : fLSColumns) column->Book(fHitsTree, perEvent);
+
+  fPMTHitsTree = new TTree("PMTHits", perEvent ? "Photon hits in PMTs, one entry per event"
+                                               : "Individual photon hits in PMTs");
+  fPMTHitsTree->Branch("eventID", &fEventID, "eventID/I");
+  for (auto& column : fPMTColumns) column->Book(fPMTHitsTree, perEvent);
+
+  // 이벤트당 한 행의 요약. 대부분의 분석은 Hits/PMTHits를 훑지 않고 이것만 읽으면 됩니다.
+  fEventsTree = new TTree("Events", "Per-event summary");
+  fEventsTree->Branch("eventID", &fEventID, "eventID/I");
+  fEventsTree->Branch("edepTotal_MeV", &fSummary.edepTotal, "edepTotal_MeV/D");
+  fEventsTree->Branch("edepGdLS_MeV", &fSummary.edepGdLS, "edepGdLS_MeV/D");
+  fEventsTree->Branch("edepLS_MeV", &fSummary.edepLS, "edepLS_MeV/D");
+  fEventsTree->Branch("nCaptures", &fSummary.nCaptures, "nCaptures/I");
+  fEventsTree->Branch("captureX_mm", &fSummary.captureX, "captureX_mm/D");
+  fEventsTree->Branch("captureY_mm", &fSummary.captureY, "captureY_mm/D");
+  fEventsTree->Branch("captureZ_mm", &fSummary.captureZ, "captureZ_mm/D");
+  fEventsTree->Branch("captureTime_ns", &fSummary.captureTime, "captureTime_ns/D");
+  fEventsTree->Branch("captureTargetZ", &fSummary.captureTargetZ, "captureTargetZ/I");
+  fEventsTree->Branch("captureTargetA", &fSummary.captureTargetA, "captureTargetA/I");
+  fEventsTree->Branch("captureGammaMultiplicity", &fSummary.captureGammaMultiplicity, "captureGammaMultiplicity/I");
+  fEventsTree->Branch("captureGammaEnergy_MeV", &fSummary.captureGammaEnergy, "captureGammaEnergy_MeV/D");
+  fEventsTree->Branch("captureWeight", &fSummary.captureWeight, "captureWeight/D");
+  fEventsTree->Branch("nPE", &fSummary.nPE, "nPE/I");
+  fEventsTree->Branch("nPMTsHit", &fSummary.nPMTsHit, "nPMTsHit/I");
+}
+
+G4int OutputWriter::CompressionSettings() const
+{
+  namespace RCS = ROOT::RCompressionSetting;
+  struct Algorithm {
+    const char* name;
+    RCS::EAlgorithm::EValues algorithm;
+    G4int defaultLevel;
+  };
+  static const Algorithm algorithms[] = {
+    {"zlib", RCS::EAlgorithm::kZLIB, RCS::ELevel::kDefaultZLIB},
+    {"lz4", RCS::EAlgorithm::kLZ4, RCS::ELevel::kDefaultLZ4},
+    {"zstd", RCS::EAlgorithm::kZSTD, RCS::ELevel::kDefaultZSTD},
+    {"lzma", RCS::EAlgorithm::kLZMA, RCS::ELevel::kDefaultLZMA},
+  };
+
+  if (fStorage.compression == "none") return 0; // 압축하지 않음
+  for (const auto& entry : algorithms) {
+    if (fStorage.compression != entry.name) continue;
+    const G4int level = (fStorage.compressionLevel > 0) ? std::min(fStorage.compressionLevel, 9) : entry.defaultLevel;
+    return ROOT::CompressionSettings(entry.algorithm, level);
+  }
+  return RCS::EDefaults::kUseCompiledDefault;
+}
+
+void OutputWriter::ApplyStorage(TTree* tree) const
+{
+  // TTree 이름으로 지정한 값이 "all"보다 우선합니다.
+  auto lookup = [tree](const auto& settings) {
+    auto it = settings.find(tree->GetName());
+    return (it != settings.end()) ? it : settings.find("all");
+  };
+  const auto basket = lookup(fStorage.basketSize);
+  if (basket != fStorage.basketSize.end()) tree->SetBasketSize("*", basket->second);
+  const auto flush = lookup(fStorage.autoFlush);
+  if (flush != fStorage.autoFlush.end()) tree->SetAutoFlush(flush->second);
+}
+
+G4bool OutputWriter::Submit(std::unique_ptr<EventRecord> record)
+{
+  if (!IsOpen()) return false;
+
+  // 스레드별 출력: 호출한 워커 스레드가 파일을 소유하므로 바로 씁니다.
+  if (!fAsynchronous) {
+    Write(*record);
+    return true;
+  }
+
+  // 쓰기 스레드가 크게 뒤처지면 메모리가 무한정 늘지 않도록 잠시 양보합니다.
+  while (fPending.load(std::memory_order_relaxed) >= fMaxPending) {
+    std::this_thread::yield();
+  }
+  fPending.fetch_add(1, std::memory_order_relaxed);
+  fQueue.Push(std::move(record));
+  return true;
+}
+
+void OutputWriter::Run()
+{
+  auto idle = std::chrono::microseconds(50);
+  const auto maxIdle = std::chrono::milliseconds(5);
+
+  while (true) {
+    if (Drain(kDrainBatch) > 0) {
+      idle = std::chrono::microseconds(50);
+      continue;
+    }
+    // 종료 요청은 모든 생산자가 끝난 뒤에만 오므로, 여기서 한 번 더 비우면 남는 레코드가 없습니다.
+    if (fStopRequested.load(std::memory_order_acquire)) {
+      while (Drain(kDrainBatch) > 0) {}
+      break;
+    }
+    std::this_thread::sleep_for(idle);
+    if (idle < maxIdle) idle *= 2;
+  }
+}
+
+std::size_t OutputWriter::Drain(std::size_t maxRecords)
+{
+  const std::size_t pending = fPending.load(std::memory_order_relaxed);
+  if (pending > fPeakPending) fPeakPending = pending;
+
+  std::size_t n = 0;
+  std::unique_ptr<EventRecord> record;
+  while (n < maxRecords && fQueue.Pop(record)) {
+    Write(*record);
+    record.reset();
+    ++n;
+  }
+  if (n > 0) fPending.fetch_sub(n, std::memory_order_relaxed);
+  return n;
+}
+
+void OutputWriter::Write(const EventRecord& record)
+{
+  if (fRollPending) {
+    fRollPending = false;
+    ++fChunk;
+    OpenFile();
+  }
+  // 다음 파일을 열지 못했으면 나머지 레코드는 버립니다.
+  if (!fFile) return;
+
+  if (IsCheckpointing()) fCheckpoint.Insert(record.eventID);
+  if (!record.accepted) {
+    if (IsCheckpointing() && ++fEventsSinceCheckpoint >= fCheckpointInterval) SaveCheckpoint(true);
+    return;
+  }
+
+  fEventID = record.eventID;
+  if (fLayout == Layout::kVectorPerEvent) {
+    // 빈 이벤트도 한 행씩 채워 Hits / PMTHits / Events의 entry 번호를 맞춥니다.
+    for (auto& column : fLSColumns) column->Clear();
+    for (const auto& hit : record.lsHits) {
+      for (auto& column : fLSColumns) column->Append(hit);
+    }
+    fHitsTree->Fill();
+    for (auto& column : fPMTColumns) column->Clear();
+    for (const auto& hit : record.pmtHits) {
+      for (auto& column : fPMTColumns) column->Append(hit);
+    }
+    fPMTHitsTree->Fill();
+  }
+  else {
+    for (const auto& hit : record.lsHits) {
+      for (auto& column : fLSColumns) column->Set(hit);
+      fHitsTree->Fill();
+    }
+    for (const auto& hit : record.pmtHits) {
+      for (auto& column : fPMTColumns) column->Set(hit);
+      fPMTHitsTree->Fill();
+    }
+  }
+  fSummary = record.summary;
+  fEventsTree->Fill();
+  ++fEventsWritten;
+  ++fEventsInFile;
+  const G4long fileBytes = fFile->GetBytesWritten();
+  bytesWritten.fetch_add(fileBytes - fFileBytes, std::memory_order_relaxed);
+  fFileBytes = fileBytes;
+  if (IsCheckpointing() && ++fEventsSinceCheckpoint >= fCheckpointInterval) SaveCheckpoint(true);
+  if (IsRolling()) RollOver();
+}
+
+void OutputWriter::Close()
+{
+  if (!IsOpen()) return;
+
+  // 새 레코드를 더 받지 않고, 쓰기 스레드가 큐를 모두 비운 뒤 끝나기를 기다립니다.
+  fOpen.store(false, std::memory_order_release);
+  fStopRequested.store(true, std::memory_order_release);
+  if (fThread.joinable()) fThread.join();
+
+  CloseFile();
+
+  G4cout << "### OutputWriter: " << fEventsWritten << " events written";
+  if (IsRolling()) G4cout << " in " << fChunk + 1 << " files";
+  G4cout << " (peak queue depth "
+         << fPeakPending << ", compression ratio "
+         << ((fZipBytes > 0) ? static_cast<G4double>(fTotBytes) / fZipBytes : 0.) << ")." << G4endl;
+}
+
+void OutputWriter::Benchmark(const G4String& fileName, G4int nEvents)
+{
+  if (fAsynchronous || IsOpen() || nEvents <= 0) return;
+
+  // 2.5 MeV 중성자 이벤트 정도의 크기(LS 스텝 약 60개, 검출 광자 약 300개)로 합성 이벤트를 미리 만들어 둡니다.
+  // 시드를 고정하므로 설정만 바꿔 가며 결과를 비교할 수 있습니다. 생성 시간은 측정에 넣지 않습니다.
+  constexpr std::size_t kPoolSize = 256;
+  static const char* const particles[] = {"e-", "gamma", "proton", "neutron"};
+  static const char* const processes[] = {"eIoni", "compt", "hadElastic", "nCapture"};
+  static const char* const volumes[] = {"LogicLS_inner", "LogicLS_outer"};
+  static const G4int pdgCodes[] = {11, 22, 2212, 2112};
+
+  std::mt19937_64 engine(20240601);
+  std::uniform_real_distribution<G4double> uniform(0., 1.);
+  std::poisson_distribution<G4int> nSteps(60), nPhotons(300);
+  std::exponential_distribution<G4double> delay(1. / 30.); // [ns]
+
+  std::vector<EventRecord> pool(kPoolSize);
+  for (auto& record : pool) {
+    const G4int nLS = nSteps(engine);
+    for (G4int i = 0; i < nLS; ++i) {
+      LSHitRecord hit;
+      const std::size_t kind = engine() % 4;
+      hit.trackID = 1 + i / 4;
+      hit.parentID = i / 8;
+      hit.particleName = particles[kind];
+      hit.processName = processes[kind];
+      hit.volumeName = volumes[engine() % 2];
+      hit.x = 100. * (uniform(engine) - 0.5);
+      hit.y = 100. * (uniform(engine) - 0.5);
+      hit.z = 1200. * (uniform(engine) - 0.5);
+      hit.time = delay(engine);
+      hit.kineticEnergy = 2.5 * uniform(engine);
+      hit.energyDeposit = 0.1 * uniform(engine);
+      hit.pdgID = pdgCodes[kind];
+      hit.px = hit.kineticEnergy * (uniform(engine) - 0.5);
+      hit.py = hit.kineticEnergy * (uniform(engine) - 0.5);
+      hit.pz = hit.kineticEnergy * (uniform(engine) - 0.5);
+      hit.energy = hit.kineticEnergy;
+      record.lsHits.push_back(hit);
+    }
+    const G4int nPMT = nPhotons(engine);
+    for (G4int i = 0; i < nPMT; ++i) {
+      PMTHitRecord hit;
+      hit.segmentID = static_cast<G4int>(engine() % 4);
+      hit.pmtID = static_cast<G4int>(engine() % 2);
+      hit.time = 5. + delay(engine);
+      record.pmtHits.push_back(hit);
+    }
+    record.summary.nPE = nPMT;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  Open(fileName);
+  if (!IsOpen()) return;
+  for (G4int i = 0; i < nEvents; ++i) {
+    auto& record = pool[i % kPoolSize];
+    record.eventID = i;
+    Write(record);
+  }
+  Close();
+  const G4double seconds = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+
+  std::error_code error;
+  const auto fileSize = std::filesystem::file_size(fileName.c_str(), error);
+  std::remove(fileName.c_str());
+
+  const G4double megabyte = 1024. * 1024.;
+  G4cout << "### Output benchmark (" << nEvents << " events, compression " << fStorage.compression
+         << ", level " << fStorage.compressionLevel << ")\n"
+         << "    time            : " << seconds << " s (" << nEvents / seconds << " events/s)\n"
+         << "    uncompressed    : " << fTotBytes / megabyte << " MB (" << fTotBytes / megabyte / seconds << " MB/s)\n"
+         << "    written to disk : " << (error ? 0. : fileSize / megabyte) << " MB ("
+         << (error ? 0. : fileSize / megabyte / seconds) << " MB/s)\n"
+         << "    compression ratio " << ((fZipBytes > 0) ? static_cast<G4double>(fTotBytes) / fZipBytes : 0.)
+         << G4endl;
+}
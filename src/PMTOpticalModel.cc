@@ -0,0 +1,69 @@
+#include "PMTOpticalModel.hh"
+#include "PMTSD.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4SDManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <cmath>
+
+namespace {
+// 입사창 위에 있다고 판단하는 z 허용 오차
+constexpr G4double kFaceTolerance = 1.0 * um;
+}
+
+PMTOpticalModel::PMTOpticalModel(const G4String& name, G4Region* envelope, G4double faceZ,
+                                 const PMTOpticalResponse::Parameters& parameters)
+: G4VFastSimulationModel(name, envelope),
+  fResponse(parameters),
+  fFaceZ(faceZ)
+{}
+
+PMTOpticalModel::~PMTOpticalModel() {}
+
+G4bool PMTOpticalModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4OpticalPhoton::Definition();
+}
+
+G4bool PMTOpticalModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  // 입사창 면에서 PMT 안쪽(-z)으로 들어오는 광자만 넘겨받습니다.
+  const G4ThreeVector pos = fastTrack.GetPrimaryTrackLocalPosition();
+  const G4ThreeVector dir = fastTrack.GetPrimaryTrackLocalDirection();
+  if (std::abs(pos.z() - fFaceZ) > kFaceTolerance) return false;
+  if (dir.z() >= 0.) return false;
+  const G4double windowRadius = fResponse.GetParameters().windowRadius;
+  return pos.perp2() < windowRadius * windowRadius;
+}
+
+void PMTOpticalModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  const G4ThreeVector pos = fastTrack.GetPrimaryTrackLocalPosition();
+  const G4ThreeVector localDir = fastTrack.GetPrimaryTrackLocalDirection();
+  const G4double energy = track->GetKineticEnergy();
+
+  // 응답 모델은 광음극 방향을 +z로 잡으므로 z 성분을 뒤집어 넘깁니다.
+  // 입사창 면에는 유리가 없어 G4OpBoundaryProcess가 그리스→진공 굴절을 이미 처리했으므로,
+  // 넘겨받은 방향은 진공 안의 것입니다.
+  const G4ThreeVector towardCathode(localDir.x(), localDir.y(), -localDir.z());
+
+  G4double flightTime = 0.;
+  if (fResponse.DetectInVacuum(pos.x(), pos.y(), towardCathode, energy, flightTime)
+      == PMTOpticalResponse::Outcome::kDetected) {
+    auto pmtSD = static_cast<PMTSD*>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("PMTSD", false));
+    if (pmtSD) {
+      // PMT copyNo = segmentID*2 + pmtID (DetectorConstruction::Construct 참조)
+      const G4int copyNo = fastTrack.GetEnvelopePhysicalVolume()->GetCopyNo();
+      pmtSD->InsertHit(copyNo / 2, copyNo % 2, track->GetGlobalTime() + flightTime);
+    }
+  }
+
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposeTotalEnergyDeposited(0.);
+}
@@ -0,0 +1,83 @@
+#include "PMTOpticalResponse.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// PMT 내부 진공의 굴절률
+constexpr G4double kVacuumRindex = 1.0;
+}
+
+PMTOpticalResponse::PMTOpticalResponse(const Parameters& parameters)
+: fParameters(parameters)
+{}
+
+PMTOpticalResponse::~PMTOpticalResponse() {}
+
+PMTOpticalResponse::Outcome PMTOpticalResponse::Detect(G4double x, G4double y, const G4ThreeVector& dir,
+                                                       G4double nIncident, G4double energy,
+                                                       G4double& flightTime) const
+{
+  flightTime = 0.;
+  if (dir.z() <= 0.) return Outcome::kLost;
+  if (x * x + y * y >= fParameters.windowRadius * fParameters.windowRadius) return Outcome::kLost;
+
+  // 그리스 → 진공 경계의 Fresnel 투과
+  const G4ThreeVector u = dir.unit();
+  const G4double sinVac = nIncident * std::sqrt(std::max(0., 1. - u.z() * u.z()));
+  if (sinVac >= 1.) return Outcome::kReflected; // 전반사
+  const G4double nGrease = fParameters.greaseRindex ? fParameters.greaseRindex->Value(energy) : nIncident;
+  const G4double sinGrease = sinVac / nGrease;
+  const G4double cosGrease = std::sqrt(1. - sinGrease * sinGrease);
+  if (G4UniformRand() < FresnelReflectance(nGrease, kVacuumRindex, cosGrease)) return Outcome::kReflected;
+
+  return FlyToCathode(x, y, u, sinVac, std::sqrt(1. - sinVac * sinVac), energy, flightTime);
+}
+
+PMTOpticalResponse::Outcome PMTOpticalResponse::DetectInVacuum(G4double x, G4double y, const G4ThreeVector& dir,
+                                                               G4double energy, G4double& flightTime) const
+{
+  flightTime = 0.;
+  if (dir.z() <= 0.) return Outcome::kLost;
+  if (x * x + y * y >= fParameters.windowRadius * fParameters.windowRadius) return Outcome::kLost;
+
+  const G4ThreeVector u = dir.unit();
+  return FlyToCathode(x, y, u, std::sqrt(std::max(0., 1. - u.z() * u.z())), u.z(), energy, flightTime);
+}
+
+PMTOpticalResponse::Outcome PMTOpticalResponse::FlyToCathode(G4double x, G4double y, const G4ThreeVector& u,
+                                                             G4double sinVac, G4double cosVac,
+                                                             G4double energy, G4double& flightTime) const
+{
+  // 진공 안에서 광음극 평면까지 직선 비행
+  const G4double path = fParameters.cathodeDepth / cosVac;
+  const G4double transverse = std::sqrt(u.x() * u.x() + u.y() * u.y());
+  G4double hitX = x;
+  G4double hitY = y;
+  if (transverse > 0.) {
+    const G4double lateral = path * sinVac;
+    hitX += lateral * u.x() / transverse;
+    hitY += lateral * u.y() / transverse;
+  }
+  if (hitX * hitX + hitY * hitY >= fParameters.cathodeRadius * fParameters.cathodeRadius) return Outcome::kLost;
+
+  const G4double qe = fParameters.quantumEfficiency ? fParameters.quantumEfficiency->Value(energy) : 0.;
+  if (G4UniformRand() >= qe) return Outcome::kLost;
+
+  flightTime = path / c_light;
+  return Outcome::kDetected;
+}
+
+G4double PMTOpticalResponse::FresnelReflectance(G4double n1, G4double n2, G4double cosI)
+{
+  const G4double eta = n1 / n2;
+  const G4double sinT2 = eta * eta * (1. - cosI * cosI);
+  if (sinT2 >= 1.) return 1.; // 전반사
+  const G4double cosT = std::sqrt(1. - sinT2);
+  const G4double rs = (n1 * cosI - n2 * cosT) / (n1 * cosI + n2 * cosT);
+  const G4double rp = (n1 * cosT - n2 * cosI) / (n1 * cosT + n2 * cosI);
+  return 0.5 * (rs * rs + rp * rp);
+}
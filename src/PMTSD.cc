@@ -52,11 +52,12 @@ G4bool PMTSD::ProcessHits(G4Step* aStep, G4TouchableHistory* /*ROhist*/)
   // --- [수정] 기하구조 계층에 따른 정확한 ID 추출 ---
   // DetectorConstruction.cc를 기준으로, 광음극(photocathode)의 부모 계층은 다음과 같습니다:
   // Level 0: PhysPhotocathode (자신)
-  // Level 1: PhysPMT (CopyNo: 0 또는 1 -> pmtID)
-  // Level 2: PhysSegment (CopyNo: 0~24 -> segmentID)
+  // Level 1: PhysPmtVacuum (CopyNo: 항상 0)
+  // Level 2: PhysPmtGlass (CopyNo: segmentID*2 + pmtID, 월드에 직접 배치)
   auto touchable = aStep->GetPreStepPoint()->GetTouchable();
-  G4int pmtID = touchable->GetCopyNumber(1);
-  G4int segmentID = touchable->GetCopyNumber(2);
+  G4int pmtCopyNo = touchable->GetCopyNumber(2);
+  G4int segmentID = pmtCopyNo / 2;
+  G4int pmtID = pmtCopyNo % 2;
   // ----------------------------------------------------
 
   PMTHit* newHit = new PMTHit();
@@ -69,3 +70,15 @@ G4bool PMTSD::ProcessHits(G4Step* aStep, G4TouchableHistory* /*ROhist*/)
 
   return true;
 }
+
+void PMTSD::InsertHit(G4int segmentID, G4int pmtID, G4double time)
+{
+  if (!fHitsCollection) return;
+
+  PMTHit* newHit = new PMTHit();
+  newHit->SetSegmentID(segmentID);
+  newHit->SetPMTID(pmtID);
+  newHit->SetTime(time / ns);
+
+  fHitsCollection->insert(newHit);
+}
@@ -0,0 +1,163 @@
+#include "PhysicsTableCache.hh"
+
+#include "G4EmParameters.hh"
+#include "G4Material.hh"
+#include "G4ParticleTable.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessTable.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4RunManagerKernel.hh"
+#include "G4StateManager.hh"
+#include "G4Version.hh"
+#include "G4VUserPhysicsList.hh"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+// 캐시가 완전히 쓰였다는 표시이자, 키를 만든 구성의 기록입니다.
+const char* kStampFile = "configuration.txt";
+
+// 구현에 따라 값이 달라지는 std::hash 대신 FNV-1a를 써서 어느 빌드에서나 같은 키가 나오게 합니다.
+G4String HashKey(const G4String& text)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+}
+
+PhysicsTableCache::PhysicsTableCache(const G4String& directory)
+: G4VStateDependent(),
+  fDirectory(directory),
+  fStorePending(false)
+{}
+
+PhysicsTableCache::~PhysicsTableCache() {}
+
+G4String PhysicsTableCache::ComputeConfiguration() const
+{
+    std::ostringstream config;
+    config << std::setprecision(10) << G4Version << "\n";
+
+    // 입자별 프로세스 목록과 활성화 상태 (물리 리스트와 -p 프로파일을 반영)
+    auto particleIterator = G4ParticleTable::GetParticleTable()->GetIterator();
+    particleIterator->reset();
+    while ((*particleIterator)()) {
+        const G4ParticleDefinition* particle = particleIterator->value();
+        const G4ProcessManager* processManager = particle->GetProcessManager();
+        if (!processManager) continue;
+        const G4ProcessVector* processes = processManager->GetProcessList();
+        config << particle->GetParticleName() << ":";
+        for (std::size_t i = 0; i < processes->size(); ++i) {
+            config << " " << (*processes)[i]->GetProcessName()
+                   << (processManager->GetProcessActivation(static_cast<G4int>(i)) ? "" : "(off)");
+        }
+        config << "\n";
+    }
+
+    G4EmParameters::Instance()->StreamInfo(config);
+
+    for (const G4Material* material : *G4Material::GetMaterialTable()) {
+        config << material->GetName() << " " << material->GetDensity() << " " << material->GetState() << " "
+               << material->GetTemperature() << " " << material->GetPressure() << " "
+               << material->GetIonisation()->GetMeanExcitationEnergy();
+        const G4double* fractions = material->GetFractionVector();
+        for (std::size_t i = 0; i < material->GetNumberOfElements(); ++i) {
+            config << " " << material->GetElement(static_cast<G4int>(i))->GetName() << "=" << fractions[i];
+        }
+        config << "\n";
+    }
+
+    for (const G4Region* region : *G4RegionStore::GetInstance()) {
+        config << region->GetName() << ":";
+        if (const G4ProductionCuts* cuts = region->GetProductionCuts()) {
+            for (G4int i = 0; i < NumberOfG4CutIndex; ++i) config << " " << cuts->GetProductionCut(i);
+        }
+        config << "\n";
+    }
+    return config.str();
+}
+
+G4bool PhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+    const G4ApplicationState currentState = G4StateManager::GetStateManager()->GetCurrentState();
+    G4VUserPhysicsList* physicsList = G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList();
+    if (!physicsList) return true;
+
+    if (requestedState == G4State_Init && currentState != G4State_Init) {
+        // 첫 Initialize()에서 Init으로 들어갈 때는 아직 프로세스가 없습니다. 물리 테이블을 만드는 Init만 다룹니다.
+        if (G4ProcessTable::GetProcessTable()->Length() == 0) return true;
+
+        const G4String configuration = ComputeConfiguration();
+        const G4String key = HashKey(configuration);
+        if (key == fKey) return true;
+        fKey = key;
+        fConfiguration = configuration;
+
+        const fs::path cache = fs::path(fDirectory) / fKey;
+        if (fs::exists(cache / kStampFile)) {
+            G4cout << "PhysicsTableCache: retrieving physics tables from " << cache.string() << G4endl;
+            physicsList->SetPhysicsTableRetrieved(cache.string() + "/");
+            fStorePending = false;
+        }
+        else {
+            G4cout << "PhysicsTableCache: no tables for this configuration, they will be stored in "
+                   << cache.string() << G4endl;
+            physicsList->ResetPhysicsTableRetrieved();
+            fStorePending = true;
+        }
+    }
+    else if (currentState == G4State_Init && requestedState != G4State_Init && fStorePending) {
+        // 커플 테이블이 비어 있으면 아직 물리 테이블을 만들지 않은 것입니다.
+        if (G4ProductionCutsTable::GetProductionCutsTable()->GetTableSize() == 0) return true;
+        // Init에 머무는 동안 구성이 바뀌었으면 (예: 다시 만든 기하구조) 이 키로 저장하지 않습니다.
+        if (HashKey(ComputeConfiguration()) != fKey) {
+            fKey = "";
+            return true;
+        }
+        fStorePending = false;
+        Store();
+    }
+    return true;
+}
+
+void PhysicsTableCache::Store()
+{
+    G4VUserPhysicsList* physicsList = G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList();
+    const fs::path cache = fs::path(fDirectory) / fKey;
+    const fs::path temporary = fs::path(fDirectory) / (fKey + ".tmp" + std::to_string(getpid()));
+
+    std::error_code error;
+    fs::create_directories(temporary, error);
+    if (error || !physicsList->StorePhysicsTable(temporary.string() + "/")) {
+        G4cerr << "PhysicsTableCache: could not store physics tables in " << temporary.string() << G4endl;
+        fs::remove_all(temporary, error);
+        return;
+    }
+    std::ofstream(temporary / kStampFile) << fConfiguration;
+
+    // 다른 작업이 먼저 같은 캐시를 만들었으면 그쪽을 그대로 두고 이 복사본을 지웁니다.
+    fs::rename(temporary, cache, error);
+    if (error) {
+        fs::remove_all(temporary, error);
+        return;
+    }
+    G4cout << "PhysicsTableCache: physics tables stored in " << cache.string() << G4endl;
+}
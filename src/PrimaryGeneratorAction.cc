@@ -1,4 +1,6 @@
 #include "PrimaryGeneratorAction.hh"
+#include "Checkpoint.hh"
+#include "EventSeeder.hh"
 
 #include "G4Event.hh"
 #include "G4GeneralParticleSource.hh"
@@ -16,5 +18,9 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
+  // 이벤트 시드 모드에서는 이 이벤트의 난수열이 스레드 배치와 상관없이 정해지도록 먼저 다시 시드합니다.
+  EventSeeder::Reseed(anEvent);
+  // 재개한 런에서 이미 기록된 이벤트는 1차 입자 없이 곧바로 끝냅니다.
+  if (Checkpoint::Completed().Contains(anEvent->GetEventID())) return;
   fGPS->GeneratePrimaryVertex(anEvent);
 }
@@ -0,0 +1,148 @@
+#include "ProgressMonitor.hh"
+#include "OutputWriter.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+// 스레드 ID로 바로 찾는 카운터. 순차 모드와 마스터는 0번을 씁니다.
+constexpr G4int kMaxThreads = 1024;
+std::array<std::atomic<G4long>, kMaxThreads> threadEvents;
+std::atomic<G4long> totalHits(0);
+
+std::atomic<G4long>& ThisThreadEvents()
+{
+  return threadEvents[std::max(0, G4Threading::G4GetThreadId()) % kMaxThreads];
+}
+
+G4String FormatDuration(G4double seconds)
+{
+  const auto total = static_cast<long>(seconds);
+  char text[32];
+  std::snprintf(text, sizeof(text), "%02ld:%02ld:%02ld", total / 3600, (total / 60) % 60, total % 60);
+  return text;
+}
+}
+
+ProgressMonitor::ProgressMonitor()
+: fRunID(0),
+  fEventsToProcess(0),
+  fInterval(0.),
+  fBytesAtStart(0),
+  fStopRequested(false)
+{}
+
+ProgressMonitor::~ProgressMonitor()
+{
+  Stop();
+}
+
+void ProgressMonitor::CountEvent()
+{
+  ThisThreadEvents().fetch_add(1, std::memory_order_relaxed);
+}
+
+void ProgressMonitor::AddHits(G4long nHits)
+{
+  totalHits.fetch_add(nHits, std::memory_order_relaxed);
+}
+
+void ProgressMonitor::Start(G4int runID, G4long eventsToProcess, G4double interval, const G4String& statusFile)
+{
+  Stop();
+  if (interval <= 0.) return;
+
+  // 마스터의 BeginOfRunAction은 워커가 이벤트를 시작하기 전이므로 카운터를 안전하게 비울 수 있습니다.
+  for (auto& count : threadEvents) count = 0;
+  totalHits = 0;
+  fRunID = runID;
+  fEventsToProcess = eventsToProcess;
+  fInterval = interval;
+  fStatusFile = statusFile;
+  fBytesAtStart = OutputWriter::GetBytesWritten();
+  fStartTime = std::chrono::steady_clock::now();
+  fStopRequested = false;
+  fThread = std::thread(&ProgressMonitor::Run, this);
+}
+
+void ProgressMonitor::Stop()
+{
+  if (!fThread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStopRequested = true;
+  }
+  fWakeUp.notify_all();
+  fThread.join();
+  Report(true);
+}
+
+void ProgressMonitor::Run()
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  const auto interval = std::chrono::duration<G4double>(fInterval);
+  while (!fWakeUp.wait_for(lock, interval, [this] { return fStopRequested; })) {
+    Report(false);
+  }
+}
+
+void ProgressMonitor::Report(G4bool finished)
+{
+  const std::chrono::duration<G4double> elapsed = std::chrono::steady_clock::now() - fStartTime;
+  const G4double seconds = std::max(elapsed.count(), 1e-9);
+
+  G4long done = 0;
+  G4int nThreads = 0;
+  G4double minRate = 0.;
+  G4double maxRate = 0.;
+  G4int slowestThread = -1;
+  std::ostringstream threads;
+  for (G4int i = 0; i < kMaxThreads; ++i) {
+    const G4long events = threadEvents[i].load(std::memory_order_relaxed);
+    if (events == 0) continue;
+    const G4double rate = events / seconds;
+    if (nThreads == 0 || rate < minRate) {
+      minRate = rate;
+      slowestThread = i;
+    }
+    maxRate = std::max(maxRate, rate);
+    threads << (nThreads++ ? "," : "") << "{\"id\":" << i << ",\"events\":" << events << ",\"events_per_s\":" << rate
+            << "}";
+    done += events;
+  }
+  const G4double rate = done / seconds;
+  const G4double eta = (rate > 0.) ? (fEventsToProcess - done) / rate : -1.;
+  const G4double hitsPerEvent = (done > 0) ? static_cast<G4double>(totalHits.load()) / done : 0.;
+  const G4long bytes = OutputWriter::GetBytesWritten() - fBytesAtStart;
+
+  std::ostringstream line;
+  line << std::fixed << std::setprecision(1) << "### Progress: " << done << "/" << fEventsToProcess << " events ("
+       << ((fEventsToProcess > 0) ? 100. * done / fEventsToProcess : 0.) << " %), " << rate << " ev/s";
+  if (nThreads > 0) {
+    line << " (" << rate / nThreads << " ev/s/thread, min " << minRate << " [thread " << slowestThread << "], max "
+         << maxRate << ")";
+  }
+  line << ", " << (finished ? "elapsed " + FormatDuration(seconds) : "ETA " + (eta >= 0. ? FormatDuration(eta) : G4String("?")))
+       << ", " << hitsPerEvent << " hits/event, " << bytes / 1048576. << " MB written";
+  G4cout << line.str() << G4endl;
+
+  if (fStatusFile.empty()) return;
+  const G4String temporary = fStatusFile + ".tmp";
+  {
+    std::ofstream status(temporary);
+    status << "{\"run\":" << fRunID << ",\"state\":\"" << (finished ? "finished" : "running") << "\""
+           << ",\"updated\":" << static_cast<long>(std::time(nullptr)) << ",\"elapsed_s\":" << seconds
+           << ",\"events_done\":" << done << ",\"events_total\":" << fEventsToProcess << ",\"events_per_s\":" << rate
+           << ",\"eta_s\":" << (finished ? 0. : eta) << ",\"hits_per_event\":" << hitsPerEvent
+           << ",\"output_bytes\":" << bytes << ",\"threads\":[" << threads.str() << "]}\n";
+  }
+  std::rename(temporary.c_str(), fStatusFile.c_str());
+}
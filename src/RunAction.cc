@@ -1,62 +1,290 @@
 #include "RunAction.hh"
+#include "Checkpoint.hh"
+#include "OnlineHistograms.hh"
+#include "OutputWriter.hh"
+#include "ProgressMonitor.hh"
+#include "StartupTimer.hh"
+#include "StepProfiler.hh"
+#include "TriggerFilter.hh"
 #include "G4AnalysisManager.hh"
+#include "G4GenericMessenger.hh"
 #include "G4Run.hh"
-#include "G4Threading.hh" // G4Threading::IsMultithreadedApplication() 사용
+#include "G4Threading.hh"
+#include "Randomize.hh"
 
-RunAction::RunAction() : G4UserRunAction()
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+
+RunAction::RunAction()
+: G4UserRunAction(),
+  fFileName("cpnr_modular_sim"),
+  fOutputMode("shared"),
+  fLayout("row"),
+  fProfile("full"),
+  fHistograms(true),
+  fRollEvents(0),
+  fRollMegabytes(0.),
+  fCheckpointInterval(0),
+  fResume(false),
+  fProgressInterval(30.)
 {
-  auto analysisManager = G4AnalysisManager::Instance();
-  analysisManager->SetVerboseLevel(1);
-  if (G4Threading::IsMultithreadedApplication()) {
-    analysisManager->SetNtupleMerging(true);
-  }
-
-  // Ntuple ID=0: Hits (에너지 증착 상세 정보)
-  analysisManager->CreateNtuple("Hits", "Hit-by-hit energy deposition data");
-  analysisManager->CreateNtupleIColumn("eventID");        // col 0
-  analysisManager->CreateNtupleIColumn("trackID");        // col 1
-  analysisManager->CreateNtupleIColumn("parentID");       // col 2
-  analysisManager->CreateNtupleSColumn("particleName");   // col 3
-  analysisManager->CreateNtupleSColumn("processName");    // col 4
-  analysisManager->CreateNtupleSColumn("volumeName");     // col 5
-  analysisManager->CreateNtupleDColumn("x_mm");           // col 6
-  analysisManager->CreateNtupleDColumn("y_mm");           // col 7
-  analysisManager->CreateNtupleDColumn("z_mm");           // col 8
-  analysisManager->CreateNtupleDColumn("time_ns");        // col 9
-  analysisManager->CreateNtupleDColumn("kineticEnergy_MeV"); // col 10
-  analysisManager->CreateNtupleDColumn("energyDeposit_MeV"); // col 11
-  
-  // --- [수정] 새로운 컬럼 추가 ---
-  analysisManager->CreateNtupleIColumn("pdgID");          // col 12
-  analysisManager->CreateNtupleDColumn("px_MeV");         // col 13
-  analysisManager->CreateNtupleDColumn("py_MeV");         // col 14
-  analysisManager->CreateNtupleDColumn("pz_MeV");         // col 15
-  analysisManager->CreateNtupleDColumn("energy_MeV");     // col 16
-  // ---------------------------------
-  
-  analysisManager->FinishNtuple();
-
-  // Ntuple ID=1: PMTHits (개별 광자 검출 정보)
-  analysisManager->CreateNtuple("PMTHits", "Individual photon hits in PMTs");
-  analysisManager->CreateNtupleIColumn("eventID");
-  analysisManager->CreateNtupleIColumn("segmentID");
-  analysisManager->CreateNtupleIColumn("pmtID");
-  analysisManager->CreateNtupleDColumn("time_ns");
-  analysisManager->FinishNtuple();
-}
-
-RunAction::~RunAction() {}
+  OnlineHistograms::Book();
+  DefineCommands();
+}
+
+RunAction::~RunAction()
+{
+  if (fThreadWriter) OutputWriter::SetThreadWriter(nullptr);
+}
+
+void RunAction::DefineCommands()
+{
+  fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/output/", "Output file control");
+  fMessenger->DeclareProperty("fileName", fFileName, "Output file name without the .root extension");
+  auto& modeCmd = fMessenger->DeclareProperty("mode", fOutputMode,
+      "shared: one file written by a writer thread, perThread: one file per worker (<fileName>_tN.root)");
+  modeCmd.SetCandidates("shared perThread");
+  auto& layoutCmd = fMessenger->DeclareProperty("layout", fLayout,
+      "row: one Hits/PMTHits row per hit, vector: one row per event with std::vector columns");
+  layoutCmd.SetCandidates("row vector");
+  auto& profileCmd = fMessenger->DeclareProperty("profile", fProfile,
+      "Hits/PMTHits columns: full (all, double), physics (no strings, float), minimal (position/time/edep only)");
+  profileCmd.SetCandidates("full physics minimal");
+
+  fMessenger->DeclareProperty("histograms", fHistograms,
+      "Fill the online histograms and write them to <fileName>_histos.root");
+
+  auto& rollEventsCmd = fMessenger->DeclareProperty("rollEvents", fRollEvents,
+      "Start a new numbered output file after this many events (0: off)");
+  rollEventsCmd.SetRange("rollEvents>=0");
+  auto& rollSizeCmd = fMessenger->DeclareProperty("rollMegabytes", fRollMegabytes,
+      "Start a new numbered output file once the current one exceeds this size in MB (0: off)");
+  rollSizeCmd.SetRange("rollMegabytes>=0");
+
+  auto& compressionCmd = fMessenger->DeclareProperty("compression", fStorage.compression,
+      "ROOT compression algorithm (default keeps the ROOT default)");
+  compressionCmd.SetCandidates("default none zlib lz4 zstd lzma");
+  auto& levelCmd = fMessenger->DeclareProperty("compressionLevel", fStorage.compressionLevel,
+      "Compression level 1-9, -1 for the default level of the algorithm");
+  levelCmd.SetRange("compressionLevel>=-1 && compressionLevel<=9");
+  fMessenger->DeclareMethod("basketSize", &RunAction::SetBasketSize,
+      "Basket size per branch: <Hits|PMTHits|Events|all> <bytes>");
+  fMessenger->DeclareMethod("autoFlush", &RunAction::SetAutoFlush,
+      "Cluster size: <Hits|PMTHits|Events|all> <n> (n>0: entries, n<0: bytes, 0: off)");
+  fCheckpointMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/checkpoint/", "Checkpointing and resuming runs");
+  auto& intervalCmd = fCheckpointMessenger->DeclareProperty("interval", fCheckpointInterval,
+      "AutoSave the output and record completed events every N written events (0: off)");
+  intervalCmd.SetRange("interval>=0");
+  auto& resumeCmd = fCheckpointMessenger->DeclareProperty("resume", fResume,
+      "Skip events recorded in <fileName>_run<ID>.ckpt and continue each interrupted run in a new output file");
+  resumeCmd.SetToBeBroadcasted(false);
+
+  fProgressMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/progress/", "Run progress reporting");
+  auto& progressCmd = fProgressMessenger->DeclareProperty("interval", fProgressInterval,
+      "Seconds between progress reports aggregated over all threads (0: off)");
+  progressCmd.SetToBeBroadcasted(false);
+  auto& statusCmd = fProgressMessenger->DeclareProperty("statusFile", fStatusFile,
+      "JSON status file rewritten at every report (default: <fileName>_status.json)");
+  statusCmd.SetToBeBroadcasted(false);
+
+  auto& benchmarkCmd = fMessenger->DeclareMethod("benchmark", &RunAction::Benchmark,
+      "Write N synthetic events with the current layout/profile/compression and report throughput");
+  benchmarkCmd.SetToBeBroadcasted(false);
+}
+
+void RunAction::SetBasketSize(const G4String& args)
+{
+  std::istringstream is(args);
+  G4String tree;
+  G4int bytes = 0;
+  if (!(is >> tree >> bytes) || bytes <= 0) {
+    G4cout << "### /myApp/output/basketSize: expected <tree|all> <bytes>, got \"" << args << "\"" << G4endl;
+    return;
+  }
+  fStorage.basketSize[tree] = bytes;
+}
+
+void RunAction::SetAutoFlush(const G4String& args)
+{
+  std::istringstream is(args);
+  G4String tree;
+  G4long entries = 0;
+  if (!(is >> tree >> entries)) {
+    G4cout << "### /myApp/output/autoFlush: expected <tree|all> <n>, got \"" << args << "\"" << G4endl;
+    return;
+  }
+  fStorage.autoFlush[tree] = entries;
+}
+
+void RunAction::Benchmark(G4int nEvents)
+{
+  // 런 중에 열려 있는 출력과 섞이지 않도록 별도의 동기식 writer와 파일을 씁니다.
+  OutputWriter writer(false);
+  writer.SetLayout(GetLayout());
+  writer.SetProfile(GetProfile());
+  writer.SetStorage(fStorage);
+  writer.Benchmark(fFileName + "_benchmark.root", nEvents);
+}
+
+OutputWriter::Layout RunAction::GetLayout() const
+{
+  return (fLayout == "vector") ? OutputWriter::Layout::kVectorPerEvent : OutputWriter::Layout::kRowPerHit;
+}
+
+OutputWriter::Profile RunAction::GetProfile() const
+{
+  if (fProfile == "minimal") return OutputWriter::Profile::kMinimal;
+  if (fProfile == "physics") return OutputWriter::Profile::kPhysics;
+  return OutputWriter::Profile::kFull;
+}
+
+G4String RunAction::OutputBaseName() const
+{
+  // 재개한 런은 중단된 런의 파일을 덮어쓰지 않도록 번호를 붙인 새 이름으로 씁니다.
+  const G4int resumeCount = Checkpoint::Completed().GetResumeCount();
+  return (resumeCount > 0) ? fFileName + "_resume" + std::to_string(resumeCount) : fFileName;
+}
+
+G4String RunAction::CheckpointBaseName(G4int runID) const
+{
+  // 한 매크로에서 /run/beamOn을 여러 번 해도 런마다 체크포인트와 엔진 상태가 따로 남습니다.
+  return fFileName + "_run" + std::to_string(runID);
+}
+
+void RunAction::PrepareCheckpoint(G4int runID)
+{
+  Checkpoint completed;
+  completed.SetRunID(runID);
+  const G4String base = CheckpointBaseName(runID);
+  const G4String rndmFile = base + ".rndm";
+  G4bool resumed = false;
+
+  if (fResume) {
+    // 이 런의 공유 출력 <이름>_run<ID>.ckpt와 스레드별 출력 <이름>_run<ID>_tN.ckpt를 모두 합칩니다.
+    namespace fs = std::filesystem;
+    const fs::path basePath(base);
+    const fs::path dir = basePath.has_parent_path() ? basePath.parent_path() : fs::path(".");
+    const std::string stem = basePath.filename().string();
+    G4int nLoaded = 0;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(dir, error)) {
+      const std::string name = entry.path().filename().string();
+      const G4bool shared = (name == stem + ".ckpt");
+      const G4bool thread = name.size() > stem.size() + 7 && name.compare(0, stem.size() + 2, stem + "_t") == 0 &&
+                            name.compare(name.size() - 5, 5, ".ckpt") == 0;
+      if (!shared && !thread) continue;
+
+      Checkpoint checkpoint;
+      if (!checkpoint.Load(entry.path().string())) continue;
+      if (checkpoint.GetRunID() != runID) {
+        G4cout << "### /myApp/checkpoint/resume: " << name << " belongs to run " << checkpoint.GetRunID()
+               << ", ignored for run " << runID << "." << G4endl;
+        continue;
+      }
+      ++nLoaded;
+      // 중단 당시 쓰던 파일(.part)에는 마지막 체크포인트까지의 이벤트가 복구 가능한 상태로 남아 있습니다.
+      const G4String& output = checkpoint.GetOutputFile();
+      const G4String part = ".part";
+      if (output.size() > part.size() && output.compare(output.size() - part.size(), part.size(), part) == 0 &&
+          fs::exists(output.c_str())) {
+        std::rename(output.c_str(), output.substr(0, output.size() - part.size()).c_str());
+      }
+      completed.Merge(checkpoint);
+    }
+
+    if (nLoaded == 0) {
+      G4cout << "### /myApp/checkpoint/resume: no checkpoint for run " << runID << " of " << fFileName
+             << ", starting it from the beginning." << G4endl;
+    }
+    else {
+      // 같은 난수 엔진 상태에서 시작하면 MT의 이벤트별 시드가 원래 런과 같아, 남은 이벤트가 그대로 재현됩니다.
+      if (fs::exists(rndmFile.c_str())) G4Random::restoreEngineStatus(rndmFile.c_str());
+      completed.SetResumeCount(completed.GetResumeCount() + 1);
+      resumed = true;
+      G4cout << "### Resuming run " << runID << " of " << fFileName << ": " << completed.GetNumberOfEvents()
+             << " events already written are skipped." << G4endl;
+    }
+  }
+  if (!resumed && fCheckpointInterval > 0) {
+    G4Random::saveEngineStatus(rndmFile.c_str());
+  }
+  Checkpoint::SetCompleted(completed);
+}
+
+G4bool RunAction::IsPerThreadOutput() const
+{
+  // 순차 모드에는 워커가 없으므로 항상 공유 출력을 사용합니다.
+  return fOutputMode == "perThread" && G4Threading::IsMultithreadedApplication();
+}
 
 void RunAction::BeginOfRunAction(const G4Run* run)
 {
-  auto analysisManager = G4AnalysisManager::Instance();
-  analysisManager->OpenFile("cpnr_modular_sim.root");
+  const G4bool perThread = IsPerThreadOutput();
+  const auto layout = GetLayout();
+  const auto profile = GetProfile();
+  const auto rollBytes = static_cast<G4long>(fRollMegabytes * 1024. * 1024.);
+
+  // 공유 출력 파일은 프로세스 전체에서 하나의 쓰기 스레드가 소유합니다.
+  // 마스터의 BeginOfRunAction은 워커들이 이벤트를 시작하기 전에 호출됩니다.
+  if (IsMaster()) {
+    // 첫 런이 시작되는 시점에는 물리 테이블까지 모두 준비되어 있습니다.
+    StartupTimer::Print();
+    TriggerFilter::ResetStatistics();
+    PrepareCheckpoint(run->GetRunID());
+    if (!perThread) {
+      OutputWriter::Instance()->SetLayout(layout);
+      OutputWriter::Instance()->SetProfile(profile);
+      OutputWriter::Instance()->SetStorage(fStorage);
+      OutputWriter::Instance()->SetRollover(fRollEvents, rollBytes);
+      OutputWriter::Instance()->SetCheckpoint(CheckpointBaseName(run->GetRunID()) + ".ckpt", fCheckpointInterval, Checkpoint::Completed());
+      OutputWriter::Instance()->Open(OutputBaseName() + ".root");
+    }
+  }
+  else if (perThread) {
+    // 스레드 사이의 통신 없이 이 워커가 자신의 파일을 직접 씁니다.
+    if (!fThreadWriter) fThreadWriter = std::make_unique<OutputWriter>(false);
+    fThreadWriter->SetLayout(layout);
+    fThreadWriter->SetProfile(profile);
+    fThreadWriter->SetStorage(fStorage);
+    fThreadWriter->SetRollover(fRollEvents, rollBytes);
+    const G4String thread = "_t" + std::to_string(G4Threading::G4GetThreadId());
+    fThreadWriter->SetCheckpoint(CheckpointBaseName(run->GetRunID()) + thread + ".ckpt", fCheckpointInterval, Checkpoint::Completed());
+    fThreadWriter->Open(OutputBaseName() + thread + ".root");
+    OutputWriter::SetThreadWriter(fThreadWriter.get());
+  }
+  else {
+    OutputWriter::SetThreadWriter(nullptr);
+  }
+  // 히스토그램은 모든 스레드가 각자 채우고, 마스터가 런의 끝에서 합쳐 씁니다.
+  if (fHistograms) G4AnalysisManager::Instance()->OpenFile(OutputBaseName() + "_histos.root");
   G4cout << "### Run " << run->GetRunID() << " start." << G4endl;
+
+  if (IsMaster()) {
+    if (!fProgress) fProgress = std::make_unique<ProgressMonitor>();
+    fProgress->Start(run->GetRunID(), run->GetNumberOfEventToBeProcessed(), fProgressInterval,
+                     fStatusFile.empty() ? OutputBaseName() + "_status.json" : fStatusFile);
+  }
 }
 
 void RunAction::EndOfRunAction(const G4Run* /*run*/)
 {
+  // 마스터의 EndOfRunAction은 모든 워커의 런이 끝난 뒤에 호출되므로, 남은 레코드를 비우고 파일을 닫습니다.
+  if (IsMaster()) {
+    OutputWriter::Instance()->Close();
+    // 출력 파일을 닫은 뒤에 멈춰야 마지막 상태에 쓴 바이트 수가 모두 들어갑니다.
+    if (fProgress) fProgress->Stop();
+    TriggerFilter::PrintStatistics();
+  }
+  else if (fThreadWriter) {
+    fThreadWriter->Close();
+  }
+  StepProfiler::EndOfRun(IsMaster());
+
+  // 워커의 Write()는 히스토그램을 마스터에 합치고, 모든 워커가 끝난 뒤 마스터의 Write()가 파일에 씁니다.
   auto analysisManager = G4AnalysisManager::Instance();
-  analysisManager->Write();
-  analysisManager->CloseFile();
+  if (analysisManager->IsOpenFile()) {
+    analysisManager->Write();
+    analysisManager->CloseFile();
+  }
 }
@@ -0,0 +1,76 @@
+#include "SegmentOpticalModel.hh"
+#include "PMTSD.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4GenericMessenger.hh"
+#include "G4NavigationHistory.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4SDManager.hh"
+#include "G4Track.hh"
+#include "G4VTouchable.hh"
+
+SegmentOpticalModel::SegmentOpticalModel(const G4String& name, G4Region* envelope,
+                                         const SegmentRayTracer::Config& config)
+: G4VFastSimulationModel(name, envelope),
+  fTracer(std::make_unique<SegmentRayTracer>(config)),
+  fBatchSize(4096),
+  fMaxInteractions(10000)
+{
+  DefineCommands();
+}
+
+SegmentOpticalModel::~SegmentOpticalModel() {}
+
+void SegmentOpticalModel::DefineCommands()
+{
+  fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/optics/segment/", "Segment optical fast simulation");
+  fMessenger->DeclareProperty("batchSize", fBatchSize, "Number of photons traced together in one batch");
+  fMessenger->DeclareProperty("maxInteractions", fMaxInteractions, "Maximum boundary interactions per photon");
+}
+
+G4bool SegmentOpticalModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4OpticalPhoton::Definition();
+}
+
+G4bool SegmentOpticalModel::ModelTrigger(const G4FastTrack& /*fastTrack*/)
+{
+  // envelope 안의 모든 광학 광자를 즉시 넘겨받습니다.
+  return true;
+}
+
+void SegmentOpticalModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+
+  // 세그먼트는 월드 바로 아래(깊이 1)에 놓여 있으므로, 현재 볼륨에서 그만큼 올라가 copyNo를 얻습니다.
+  const G4VTouchable* touchable = track->GetTouchable();
+  G4int segmentID = touchable->GetCopyNumber(touchable->GetHistoryDepth() - 1);
+
+  // envelope이 어느 볼륨이든 세그먼트 좌표계로 바꿔 넘기도록, 내비게이션 이력의 깊이 1 변환을 씁니다.
+  const G4AffineTransform& toSegment = touchable->GetHistory()->GetTransform(1);
+  fTracer->AddPhoton(segmentID, toSegment.TransformPoint(track->GetPosition()),
+                     toSegment.TransformAxis(track->GetMomentumDirection()),
+                     track->GetKineticEnergy(), track->GetGlobalTime());
+
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposeTotalEnergyDeposited(0.);
+
+  if (static_cast<G4int>(fTracer->GetNumberOfPhotons()) >= fBatchSize) Flush();
+}
+
+void SegmentOpticalModel::Flush()
+{
+  if (fTracer->GetNumberOfPhotons() == 0) return;
+
+  fDetections.clear();
+  fTracer->SetMaxInteractions(fMaxInteractions);
+  fTracer->Trace(fDetections);
+
+  auto pmtSD = static_cast<PMTSD*>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("PMTSD", false));
+  if (!pmtSD) return;
+  for (const auto& detection : fDetections) {
+    pmtSD->InsertHit(detection.segmentID, detection.pmtID, detection.time);
+  }
+}
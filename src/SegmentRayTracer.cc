@@ -0,0 +1,318 @@
+#include "SegmentRayTracer.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+// 경계 위에 놓인 광자가 같은 면을 다시 교차하지 않도록 하는 허용 오차
+constexpr G4double kTolerance = 1.0e-6 * mm;
+// 세그먼트 외벽과 Teflon 반사재 사이의 공기층 굴절률
+constexpr G4double kAirRindex = 1.0;
+
+// 현재 층에서 다음 사건(바깥 경계, 안쪽 상자 경계, 흡수)까지의 거리를 계산하는 커널입니다.
+// 분기 없이 작성되어 있고 배열 인자가 __restrict로 선언되어 있어 SIMD로 자동 벡터화됩니다.
+// (정수 출력은 선택(select) 대신 산술식으로 계산해야 벡터화가 깨지지 않습니다.)
+void DistanceKernel(std::size_t n,
+                    const G4double* __restrict x, const G4double* __restrict y, const G4double* __restrict z,
+                    const G4double* __restrict ux, const G4double* __restrict uy, const G4double* __restrict uz,
+                    const G4double* __restrict outHx, const G4double* __restrict outHy, const G4double* __restrict outHz,
+                    const G4double* __restrict inHx, const G4double* __restrict inHy, const G4double* __restrict inHz,
+                    const G4double* __restrict absLength, const G4double* __restrict minusLogU,
+                    G4double* __restrict dist, G4int* __restrict axis, G4int* __restrict result)
+{
+  for (std::size_t i = 0; i < n; ++i) {
+    const G4double ix = 1.0 / ux[i];
+    const G4double iy = 1.0 / uy[i];
+    const G4double iz = 1.0 / uz[i];
+
+    // 현재 층의 바깥 상자를 빠져나가는 거리
+    const G4double tx = (std::copysign(outHx[i], ux[i]) - x[i]) * ix;
+    const G4double ty = (std::copysign(outHy[i], uy[i]) - y[i]) * iy;
+    const G4double tz = (std::copysign(outHz[i], uz[i]) - z[i]) * iz;
+    const G4double tOut = std::min(tx, std::min(ty, tz));
+    const G4int axisOut = G4int(tOut != tx) + G4int((tOut != tx) & (tOut != ty));
+
+    // 안쪽 상자로 들어가는 거리 (슬랩 교차)
+    const G4double x1 = (-inHx[i] - x[i]) * ix, x2 = (inHx[i] - x[i]) * ix;
+    const G4double y1 = (-inHy[i] - y[i]) * iy, y2 = (inHy[i] - y[i]) * iy;
+    const G4double z1 = (-inHz[i] - z[i]) * iz, z2 = (inHz[i] - z[i]) * iz;
+    const G4double nearX = std::min(x1, x2), farX = std::max(x1, x2);
+    const G4double nearY = std::min(y1, y2), farY = std::max(y1, y2);
+    const G4double nearZ = std::min(z1, z2), farZ = std::max(z1, z2);
+    const G4double tNear = std::max(nearX, std::max(nearY, nearZ));
+    const G4double tFar = std::min(farX, std::min(farY, farZ));
+    const G4int axisIn = G4int(tNear != nearX) + G4int((tNear != nearX) & (tNear != nearY));
+    const G4bool hitIn = (inHx[i] > 0.) & (tNear <= tFar) & (tNear > kTolerance) & (tNear < tOut);
+
+    const G4double tBoundary = hitIn ? tNear : tOut;
+    const G4double sAbs = absLength[i] * minusLogU[i];
+    const G4bool absorbed = sAbs < tBoundary;
+
+    dist[i] = absorbed ? sAbs : tBoundary;
+    axis[i] = axisOut + G4int(hitIn) * (axisIn - axisOut);
+    result[i] = 2 * G4int(absorbed) + G4int(!absorbed & hitIn); // 0: 바깥 경계, 1: 안쪽 경계, 2: 흡수
+  }
+}
+}
+
+SegmentRayTracer::SegmentRayTracer(const Config& config)
+: fConfig(config), fPMTResponse(config.pmt), fMaxInteractions(10000)
+{}
+
+SegmentRayTracer::~SegmentRayTracer() {}
+
+void SegmentRayTracer::AddPhoton(G4int segmentID, const G4ThreeVector& localPos, const G4ThreeVector& localDir,
+                                 G4double energy, G4double globalTime)
+{
+  const G4ThreeVector dir = localDir.unit();
+  fX.push_back(localPos.x()); fY.push_back(localPos.y()); fZ.push_back(localPos.z());
+  fUx.push_back(dir.x()); fUy.push_back(dir.y()); fUz.push_back(dir.z());
+  fTime.push_back(globalTime);
+  fEnergy.push_back(energy);
+  fSegmentID.push_back(segmentID);
+  fAlive.push_back(1);
+
+  // 굴절률과 흡수 길이는 광자 에너지에서 한 번만 평가해 둡니다.
+  std::array<G4double, kNumLayers> rindex;
+  std::array<G4double, kNumLayers> absLength;
+  for (G4int k = 0; k < kNumLayers; ++k) {
+    const Layer& layer = fConfig.layers[k];
+    rindex[k] = layer.rindex ? layer.rindex->Value(energy) : 0.;
+    absLength[k] = layer.absLength ? layer.absLength->Value(energy) : DBL_MAX;
+  }
+  fRindex.push_back(rindex);
+  fAbsLength.push_back(absLength);
+
+  // 위치를 포함하는 가장 안쪽 층을 찾습니다.
+  G4int layer = 0;
+  for (G4int k = kNumLayers - 1; k >= 0; --k) {
+    const G4ThreeVector& h = fConfig.layers[k].halfSize;
+    if (std::abs(localPos.x()) <= h.x() && std::abs(localPos.y()) <= h.y() && std::abs(localPos.z()) <= h.z()) {
+      layer = k;
+      break;
+    }
+  }
+
+  fLayer.push_back(layer);
+  fOutHx.push_back(0.); fOutHy.push_back(0.); fOutHz.push_back(0.);
+  fInHx.push_back(-1.); fInHy.push_back(-1.); fInHz.push_back(-1.);
+  fCurAbs.push_back(DBL_MAX);
+  EnterLayer(fX.size() - 1, layer);
+}
+
+void SegmentRayTracer::Trace(std::vector<Detection>& detections)
+{
+  std::size_t n = fX.size();
+  for (G4int iter = 0; iter < fMaxInteractions && n > 0; ++iter) {
+    fRand.resize(n);
+    fDist.resize(n);
+    fAxis.resize(n);
+    fResult.resize(n);
+
+    // 흡수 거리 샘플링용 난수를 묶음 전체에 대해 한 번에 생성합니다 (-ln u, 평균 자유 행로 단위).
+    G4Random::getTheEngine()->flatArray(static_cast<G4int>(n), fRand.data());
+    for (std::size_t i = 0; i < n; ++i) fRand[i] = -std::log(fRand[i]);
+    ComputeDistances(n);
+
+    std::size_t nAlive = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (fAlive[i] && Interact(i, detections)) ++nAlive;
+    }
+
+    // 살아남은 광자가 절반 이하이면 배열을 압축해 커널이 죽은 광자를 계산하지 않도록 합니다.
+    if (nAlive == 0) break;
+    if (2 * nAlive <= n) {
+      Compact();
+      n = fX.size();
+    }
+  }
+  Resize(0);
+}
+
+void SegmentRayTracer::ComputeDistances(std::size_t n)
+{
+  DistanceKernel(n, fX.data(), fY.data(), fZ.data(), fUx.data(), fUy.data(), fUz.data(),
+                 fOutHx.data(), fOutHy.data(), fOutHz.data(), fInHx.data(), fInHy.data(), fInHz.data(),
+                 fCurAbs.data(), fRand.data(), fDist.data(), fAxis.data(), fResult.data());
+}
+
+G4bool SegmentRayTracer::Interact(std::size_t i, std::vector<Detection>& detections)
+{
+  const G4int layer = fLayer[i];
+  const G4double d = fDist[i];
+  fX[i] += fUx[i] * d;
+  fY[i] += fUy[i] * d;
+  fZ[i] += fUz[i] * d;
+  fTime[i] += d * fRindex[i][layer] / c_light;
+
+  if (fResult[i] == kAbsorbed) {
+    fAlive[i] = 0;
+    return false;
+  }
+
+  const G4int axis = fAxis[i];
+  const G4double u = Dir(i, axis);
+  const G4double normalSign = (u > 0.) ? -1. : 1.; // 입사한 쪽을 향하는 법선의 부호
+  const G4double cosI = std::abs(u);
+  const G4double n1 = fRindex[i][layer];
+
+  // --- 층 사이의 경계: Fresnel 반사 또는 굴절 ---
+  if (fResult[i] == kInnerBoundary || layer > 0) {
+    const G4bool inward = (fResult[i] == kInnerBoundary);
+    const G4int next = inward ? layer + 1 : layer - 1;
+    const G4double h = fConfig.layers[inward ? next : layer].halfSize[axis];
+    Pos(i, axis) = inward ? normalSign * h : -normalSign * h;
+
+    const G4double n2 = fRindex[i][next];
+    if (n2 <= 0.) {
+      fAlive[i] = 0;
+      return false;
+    }
+    if (G4UniformRand() < PMTOpticalResponse::FresnelReflectance(n1, n2, cosI)) {
+      Reflect(i, axis);
+    } else {
+      Refract(i, axis, normalSign, n1, n2, cosI);
+      EnterLayer(i, next);
+    }
+    return true;
+  }
+
+  // --- 세그먼트 외벽 ---
+  Pos(i, axis) = -normalSign * fConfig.layers[0].halfSize[axis];
+  const G4double energy = fEnergy[i];
+  const G4double r2 = fX[i] * fX[i] + fY[i] * fY[i];
+
+  if (axis == 2 && r2 < fConfig.couplingRadius * fConfig.couplingRadius) {
+    // 끝면의 PMT 결합 영역: 그리스로 투과한 광자는 PMT 응답 모델로 검출 여부를 결정합니다.
+    // (그리스 층 1 mm에서의 횡방향 이동은 무시합니다.)
+    const G4double nGrease = fConfig.greaseRindex ? fConfig.greaseRindex->Value(energy) : n1;
+    if (G4UniformRand() < PMTOpticalResponse::FresnelReflectance(n1, nGrease, cosI)) {
+      Reflect(i, axis);
+      return true;
+    }
+    const G4ThreeVector towardCathode(fUx[i], fUy[i], std::abs(fUz[i]));
+    G4double flightTime = 0.;
+    const auto outcome = fPMTResponse.Detect(fX[i], fY[i], towardCathode, n1, energy, flightTime);
+    if (outcome == PMTOpticalResponse::Outcome::kReflected) {
+      // 입사창에서 반사된 광자는 세그먼트로 되돌아와 Teflon 반사를 거쳐 어느 PMT에든 다시 닿을 수 있습니다.
+      Reflect(i, axis);
+      return true;
+    }
+    if (outcome == PMTOpticalResponse::Outcome::kDetected) {
+      // +z 끝면은 copyNo*2 (pmtID 0), -z 끝면은 copyNo*2+1 (pmtID 1) PMT에 해당합니다.
+      detections.push_back({fSegmentID[i], (fUz[i] > 0.) ? 0 : 1, fTime[i] + flightTime});
+    }
+    fAlive[i] = 0;
+    return false;
+  }
+
+  // 공기층에서의 Fresnel 반사(전반사 포함) 후, 투과한 광자는 Teflon에서 난반사되거나 흡수됩니다.
+  if (G4UniformRand() < PMTOpticalResponse::FresnelReflectance(n1, kAirRindex, cosI)) {
+    Reflect(i, axis);
+    return true;
+  }
+  const G4double reflectivity = fConfig.wrapReflectivity ? fConfig.wrapReflectivity->Value(energy) : 0.;
+  if (G4UniformRand() >= reflectivity) {
+    fAlive[i] = 0;
+    return false;
+  }
+  ReflectDiffuse(i, axis, normalSign, n1);
+  return true;
+}
+
+void SegmentRayTracer::EnterLayer(std::size_t i, G4int layer)
+{
+  fLayer[i] = layer;
+  const G4ThreeVector& out = fConfig.layers[layer].halfSize;
+  fOutHx[i] = out.x(); fOutHy[i] = out.y(); fOutHz[i] = out.z();
+  if (layer + 1 < kNumLayers) {
+    const G4ThreeVector& in = fConfig.layers[layer + 1].halfSize;
+    fInHx[i] = in.x(); fInHy[i] = in.y(); fInHz[i] = in.z();
+  } else {
+    fInHx[i] = -1.; fInHy[i] = -1.; fInHz[i] = -1.;
+  }
+  fCurAbs[i] = fAbsLength[i][layer];
+
+  // RINDEX가 없는 물질은 G4OpBoundaryProcess와 마찬가지로 광자를 흡수합니다.
+  if (fRindex[i][layer] <= 0.) fAlive[i] = 0;
+}
+
+void SegmentRayTracer::Reflect(std::size_t i, G4int axis)
+{
+  Dir(i, axis) = -Dir(i, axis);
+}
+
+void SegmentRayTracer::Refract(std::size_t i, G4int axis, G4double normalSign, G4double n1, G4double n2, G4double cosI)
+{
+  const G4double eta = n1 / n2;
+  const G4double sinT2 = eta * eta * (1. - cosI * cosI);
+  const G4double cosT = std::sqrt(std::max(0., 1. - sinT2));
+  for (G4int a = 0; a < 3; ++a) {
+    if (a != axis) Dir(i, a) *= eta;
+  }
+  Dir(i, axis) = -normalSign * cosT;
+}
+
+void SegmentRayTracer::ReflectDiffuse(std::size_t i, G4int axis, G4double normalSign, G4double n)
+{
+  // 공기 중에서 Lambertian 분포로 방향을 뽑은 뒤 외부 PMMA 안으로 굴절시킵니다.
+  const G4double cosA = std::sqrt(G4UniformRand());
+  const G4double sinA = std::sqrt(1. - cosA * cosA);
+  const G4double phi = CLHEP::twopi * G4UniformRand();
+  const G4double sinT = sinA / n;
+  const G4double cosT = std::sqrt(1. - sinT * sinT);
+
+  const G4int a1 = (axis + 1) % 3;
+  const G4int a2 = (axis + 2) % 3;
+  Dir(i, axis) = normalSign * cosT;
+  Dir(i, a1) = sinT * std::cos(phi);
+  Dir(i, a2) = sinT * std::sin(phi);
+}
+
+void SegmentRayTracer::Compact()
+{
+  std::size_t j = 0;
+  for (std::size_t i = 0; i < fX.size(); ++i) {
+    if (!fAlive[i]) continue;
+    if (i != j) MoveEntry(j, i);
+    ++j;
+  }
+  Resize(j);
+}
+
+void SegmentRayTracer::MoveEntry(std::size_t dst, std::size_t src)
+{
+  fX[dst] = fX[src]; fY[dst] = fY[src]; fZ[dst] = fZ[src];
+  fUx[dst] = fUx[src]; fUy[dst] = fUy[src]; fUz[dst] = fUz[src];
+  fTime[dst] = fTime[src];
+  fEnergy[dst] = fEnergy[src];
+  fLayer[dst] = fLayer[src];
+  fSegmentID[dst] = fSegmentID[src];
+  fAlive[dst] = fAlive[src];
+  fRindex[dst] = fRindex[src];
+  fAbsLength[dst] = fAbsLength[src];
+  fOutHx[dst] = fOutHx[src]; fOutHy[dst] = fOutHy[src]; fOutHz[dst] = fOutHz[src];
+  fInHx[dst] = fInHx[src]; fInHy[dst] = fInHy[src]; fInHz[dst] = fInHz[src];
+  fCurAbs[dst] = fCurAbs[src];
+}
+
+void SegmentRayTracer::Resize(std::size_t n)
+{
+  fX.resize(n); fY.resize(n); fZ.resize(n);
+  fUx.resize(n); fUy.resize(n); fUz.resize(n);
+  fTime.resize(n);
+  fEnergy.resize(n);
+  fLayer.resize(n);
+  fSegmentID.resize(n);
+  fAlive.resize(n);
+  fRindex.resize(n);
+  fAbsLength.resize(n);
+  fOutHx.resize(n); fOutHy.resize(n); fOutHz.resize(n);
+  fInHx.resize(n); fInHy.resize(n); fInHz.resize(n);
+  fCurAbs.resize(n);
+}
@@ -0,0 +1,204 @@
+#include "SlowEventMonitor.hh"
+#include "EventSeeder.hh"
+
+#include "G4Event.hh"
+#include "G4GenericMessenger.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4Track.hh"
+#include "G4UImanager.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace {
+// 여러 워커가 같은 요약 파일에 덧붙이므로 한 이벤트의 기록이 섞이지 않게 합니다.
+std::mutex dumpMutex;
+
+G4double ThreadCPUSeconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+}
+
+SlowEventMonitor::SlowEventMonitor()
+: fThreshold(0.),
+  fFactor(0.),
+  fMinEvents(100),
+  fMaxDumps(100),
+  fStartTime(0.),
+  fRunID(-1),
+  fDumps(0),
+  fEvents(0)
+{
+  fTimeBins.fill(0);
+  DefineCommands();
+}
+
+SlowEventMonitor::~SlowEventMonitor() {}
+
+void SlowEventMonitor::DefineCommands()
+{
+  fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/slowEvents/", "Slow event detection and dumps");
+  fMessenger->DeclareMethod("threshold", &SlowEventMonitor::SetThreshold,
+      "Dump events that take more than this many CPU seconds (0: off)");
+  fMessenger->DeclareMethod("factor", &SlowEventMonitor::SetFactor,
+      "Dump events that take more than this multiple of the median event CPU time (0: off)");
+  auto& minEventsCmd = fMessenger->DeclareProperty("minEvents", fMinEvents,
+      "Events a thread must have processed before the factor criterion applies");
+  minEventsCmd.SetRange("minEvents>=1");
+  auto& maxDumpsCmd = fMessenger->DeclareProperty("maxDumps", fMaxDumps,
+      "Maximum number of dumped events per thread and run");
+  maxDumpsCmd.SetRange("maxDumps>=0");
+}
+
+void SlowEventMonitor::SetThreshold(G4double seconds)
+{
+  fThreshold = std::max(0., seconds);
+  StoreRandomStatus();
+}
+
+void SlowEventMonitor::SetFactor(G4double factor)
+{
+  fFactor = std::max(0., factor);
+  StoreRandomStatus();
+}
+
+void SlowEventMonitor::StoreRandomStatus()
+{
+  // 이 스레드의 RunManager가 1차 입자를 만들기 직전의 엔진 상태를 G4Event에 남기게 합니다 (/run/storeRndmStatToEvent).
+  if (!IsEnabled()) return;
+  auto runManager = G4RunManager::GetRunManager();
+  const G4int flag = runManager->GetFlagRandomNumberStatusToG4Event();
+  if (flag == 0 || flag == 2) runManager->StoreRandomNumberStatusToG4Event(flag + 1);
+}
+
+void SlowEventMonitor::BeginOfEvent()
+{
+  if (IsEnabled()) fStepCounts.clear();
+  fStartTime = ThreadCPUSeconds();
+}
+
+void SlowEventMonitor::CountStep(const G4Track* track)
+{
+  StepCount& count = fStepCounts[track->GetDefinition()];
+  ++count.steps;
+  if (track->GetCurrentStepNumber() == 1) ++count.tracks;
+}
+
+G4double SlowEventMonitor::EndOfEvent(const G4Event* event, const EventSummaryRecord& summary)
+{
+  const G4double seconds = ThreadCPUSeconds() - fStartTime;
+  if (!IsEnabled()) return seconds;
+
+  const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+  const G4int runID = run ? run->GetRunID() : 0;
+  if (runID != fRunID) {
+    fRunID = runID;
+    fDumps = 0;
+  }
+
+  // 중앙값에는 이번 이벤트를 넣기 전의 값을 씁니다.
+  const G4double median = (fEvents > 0) ? Median() : 0.;
+  const G4bool slow = (fThreshold > 0. && seconds > fThreshold) ||
+                      (fFactor > 0. && fEvents >= fMinEvents && seconds > fFactor * median);
+  if (slow && fDumps < fMaxDumps) {
+    ++fDumps;
+    Dump(event, summary, seconds, median);
+  }
+
+  const G4int bin = static_cast<G4int>(std::floor(kBinsPerDecade * std::log10(std::max(seconds, kMinSeconds) / kMinSeconds)));
+  ++fTimeBins[std::min(bin, kNumBins - 1)];
+  ++fEvents;
+  return seconds;
+}
+
+G4double SlowEventMonitor::Median() const
+{
+  G4long seen = 0;
+  for (G4int bin = 0; bin < kNumBins; ++bin) {
+    seen += fTimeBins[bin];
+    if (2 * seen >= fEvents) return kMinSeconds * std::pow(10., (bin + 0.5) / kBinsPerDecade);
+  }
+  return kMinSeconds * std::pow(10., 10.);
+}
+
+void SlowEventMonitor::Dump(const G4Event* event, const EventSummaryRecord& summary, G4double seconds, G4double median)
+{
+  const G4String base = G4UImanager::GetUIpointer()->GetCurrentValues("/myApp/output/fileName");
+  const G4int eventID = event->GetEventID();
+  const G4String dumpFile = base + "_slow_events.txt";
+  const G4String stateFile = base + "_slow_r" + std::to_string(fRunID) + "_e" + std::to_string(eventID) + ".rndm";
+
+  // 이벤트 시드 모드에서는 PrimaryGeneratorAction이 저장된 상태를 다시 시드하므로 이벤트 ID로 재생합니다.
+  // 그렇지 않으면 G4Event에 저장된 엔진 상태(G4Random::saveFullState() 형식)를 파일로 남깁니다.
+  const G4bool eventSeeding = EventSeeder::IsEnabled();
+  const G4int flag = G4RunManager::GetRunManager()->GetFlagRandomNumberStatusToG4Event();
+  const G4bool haveState = !eventSeeding && (flag == 1 || flag == 3);
+  if (haveState) std::ofstream(stateFile) << event->GetRandomNumberStatus();
+
+  std::vector<std::pair<const G4ParticleDefinition*, StepCount>> counts(fStepCounts.begin(), fStepCounts.end());
+  std::sort(counts.begin(), counts.end(), [](const auto& a, const auto& b) { return a.second.steps > b.second.steps; });
+  G4long tracks = 0;
+  G4long steps = 0;
+  for (const auto& entry : counts) {
+    tracks += entry.second.tracks;
+    steps += entry.second.steps;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(dumpMutex);
+    std::ofstream out(dumpFile, std::ios::app);
+    out << "=== slow event\n"
+        << "run " << fRunID << "\n"
+        << "event " << eventID << "\n"
+        << "thread " << G4Threading::G4GetThreadId() << "\n"
+        << "cpu_seconds " << seconds << "\n"
+        << "median_seconds " << median << "\n";
+    for (G4int v = 0; v < event->GetNumberOfPrimaryVertex(); ++v) {
+      const G4PrimaryVertex* vertex = event->GetPrimaryVertex(v);
+      for (G4int p = 0; p < vertex->GetNumberOfParticle(); ++p) {
+        const G4PrimaryParticle* primary = vertex->GetPrimary(p);
+        const G4ThreeVector position = vertex->GetPosition() / mm;
+        const G4ThreeVector direction = primary->GetMomentumDirection();
+        out << "primary " << (primary->GetParticleDefinition() ? primary->GetParticleDefinition()->GetParticleName() : "unknown")
+            << " ekin_MeV " << primary->GetKineticEnergy() / MeV
+            << " pos_mm " << position.x() << " " << position.y() << " " << position.z()
+            << " dir " << direction.x() << " " << direction.y() << " " << direction.z()
+            << " t0_ns " << vertex->GetT0() / ns << "\n";
+      }
+    }
+    out << "captures " << summary.nCaptures << " gamma_multiplicity " << summary.captureGammaMultiplicity
+        << " gamma_energy_MeV " << summary.captureGammaEnergy << "\n"
+        << "tracks " << tracks << " steps " << steps << "\n";
+    for (const auto& entry : counts) {
+      out << "particle " << entry.first->GetParticleName() << " tracks " << entry.second.tracks
+          << " steps " << entry.second.steps << "\n";
+    }
+    if (eventSeeding) {
+      out << "replay /myApp/random/replayEvent " << eventID << " " << fRunID << "\n";
+    }
+    else if (haveState) {
+      out << "random_state " << stateFile << "\n"
+          << "replay /myApp/random/replayState " << stateFile << "\n";
+    }
+    else {
+      out << "replay unavailable (/run/storeRndmStatToEvent is off)\n";
+    }
+  }
+
+  G4cout << "### Slow event " << eventID << " (run " << fRunID << "): " << seconds << " s CPU";
+  if (median > 0.) G4cout << ", " << seconds / median << "x median";
+  G4cout << ", dumped to " << dumpFile << G4endl;
+}
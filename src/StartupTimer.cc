@@ -0,0 +1,102 @@
+#include "StartupTimer.hh"
+
+#include "G4StateManager.hh"
+#include "G4Threading.hh"
+#include "G4VStateDependent.hh"
+
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+// 모든 Scope는 마스터 스레드에서만 만들어지므로 잠금이 필요 없습니다.
+std::vector<std::pair<const char*, G4double>> phases; // 처음 기록된 순서대로 출력합니다.
+std::chrono::steady_clock::time_point startTime;
+StartupTimer::Scope* currentScope = nullptr;
+G4bool started = false;
+G4bool printed = false;
+
+void AddSeconds(const char* phase, G4double seconds)
+{
+  for (auto& entry : phases) {
+    if (G4String(entry.first) == phase) {
+      entry.second += seconds;
+      return;
+    }
+  }
+  phases.emplace_back(phase, seconds);
+}
+
+// 커널이 G4State_Init에 머무는 동안(초기화, 런 초기화의 물리 테이블 생성)을 하나의 단계로 잽니다.
+class InitStateObserver : public G4VStateDependent
+{
+public:
+  G4bool Notify(G4ApplicationState requestedState) override
+  {
+    if (requestedState == G4State_Init) {
+      if (!fScope && !printed) fScope = std::make_unique<StartupTimer::Scope>("physics tables");
+    }
+    else {
+      fScope.reset();
+    }
+    return true;
+  }
+
+private:
+  std::unique_ptr<StartupTimer::Scope> fScope;
+};
+}
+
+StartupTimer::Scope::Scope(const char* phase)
+: fPhase(phase),
+  fStart(std::chrono::steady_clock::now()),
+  fNestedSeconds(0.),
+  fParent(nullptr)
+{
+  if (!started || printed || !G4Threading::IsMasterThread()) {
+    fPhase = nullptr;
+    return;
+  }
+  fParent = currentScope;
+  currentScope = this;
+}
+
+StartupTimer::Scope::~Scope()
+{
+  if (!fPhase) return;
+  const std::chrono::duration<G4double> elapsed = std::chrono::steady_clock::now() - fStart;
+  AddSeconds(fPhase, elapsed.count() - fNestedSeconds);
+  if (fParent) fParent->fNestedSeconds += elapsed.count();
+  currentScope = fParent;
+}
+
+void StartupTimer::Start()
+{
+  if (started) return;
+  startTime = std::chrono::steady_clock::now();
+  started = true;
+  // 생성자에서 G4StateManager에 등록되며, G4StateManager가 소멸할 때 함께 지웁니다.
+  new InitStateObserver();
+}
+
+void StartupTimer::Print()
+{
+  if (!started || printed) return;
+  printed = true;
+
+  const std::chrono::duration<G4double> total = std::chrono::steady_clock::now() - startTime;
+  G4double measured = 0.;
+  // 서식은 지역 스트림에만 적용해, 이후 마스터 G4cout의 정밀도와 플래그를 바꾸지 않습니다.
+  std::ostringstream report;
+  report << std::fixed << std::setprecision(2) << "### Startup: " << total.count() << " s until the first run\n";
+  for (const auto& entry : phases) {
+    report << "    " << std::left << std::setw(20) << entry.first << std::right << std::setw(8) << entry.second
+           << " s\n";
+    measured += entry.second;
+  }
+  report << "    " << std::left << std::setw(20) << "other" << std::right << std::setw(8) << total.count() - measured
+         << " s";
+  G4cout << report.str() << G4endl;
+}
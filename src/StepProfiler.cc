@@ -0,0 +1,174 @@
+#include "StepProfiler.hh"
+#include "G4BiasingProcessInterface.hh"
+#include "G4GenericMessenger.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace {
+// 런이 끝날 때 모든 스레드의 누적값을 이름으로 합친 표
+struct Totals {
+  G4double seconds = 0.;
+  G4long steps = 0;
+};
+using NameKey = std::tuple<G4String, G4String, G4String>; // (볼륨, 입자, 프로세스)
+
+std::mutex mergeMutex;
+std::map<NameKey, Totals> merged;
+G4int mergedSampling = 1;
+G4int mergedTop = 25;
+
+G4ThreadLocal StepProfiler* threadProfiler = nullptr;
+
+// 벽시계 시간은 코어보다 스레드가 많거나 선점될 때 다른 스레드의 몫까지 더해지므로 스레드 CPU 시간을 씁니다.
+G4double ThreadCPUSeconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+
+void PrintTable(const std::vector<std::pair<G4String, Totals>>& rows, G4double total, G4int top)
+{
+  char line[256];
+  std::snprintf(line, sizeof(line), "  %7s %10s %12s %9s  %s", "share", "time[s]", "steps", "us/step", "volume / particle / process");
+  G4cout << line << G4endl;
+  const G4int n = std::min<G4int>(top, static_cast<G4int>(rows.size()));
+  for (G4int i = 0; i < n; ++i) {
+    const Totals& t = rows[i].second;
+    std::snprintf(line, sizeof(line), "  %6.2f%% %10.3f %12ld %9.3f  ", 100. * t.seconds / total, t.seconds,
+                  static_cast<long>(t.steps), t.steps > 0 ? 1e6 * t.seconds / t.steps : 0.);
+    G4cout << line << rows[i].first << G4endl;
+  }
+}
+
+std::vector<std::pair<G4String, Totals>> SortByTime(std::map<G4String, Totals>& table)
+{
+  std::vector<std::pair<G4String, Totals>> rows(table.begin(), table.end());
+  std::sort(rows.begin(), rows.end(),
+            [](const auto& a, const auto& b) { return a.second.seconds > b.second.seconds; });
+  return rows;
+}
+}
+
+StepProfiler::StepProfiler()
+: fLast(0.),
+  fTiming(false),
+  fTrackCount(0),
+  fEnabled(false),
+  fSampling(1),
+  fTop(25)
+{
+  threadProfiler = this;
+  DefineCommands();
+}
+
+StepProfiler::~StepProfiler()
+{
+  if (threadProfiler == this) threadProfiler = nullptr;
+}
+
+void StepProfiler::DefineCommands()
+{
+  fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/profile/", "Step time profiler");
+  fMessenger->DeclareProperty("enable", fEnabled,
+      "Attribute step time to (logical volume, particle, process) and print the shares at the end of the run");
+  auto& samplingCmd = fMessenger->DeclareProperty("sampling", fSampling, "Time one track out of N");
+  samplingCmd.SetRange("sampling>=1");
+  auto& topCmd = fMessenger->DeclareProperty("top", fTop, "Number of combinations printed at the end of the run");
+  topCmd.SetRange("top>=1");
+}
+
+void StepProfiler::StartTrack(const G4Track* /*track*/)
+{
+  fTiming = fEnabled && (fTrackCount++ % fSampling == 0);
+  if (fTiming) fLast = ThreadCPUSeconds();
+}
+
+void StepProfiler::Step(const G4Step* step)
+{
+  if (!fTiming) return;
+  const G4double now = ThreadCPUSeconds();
+
+  const G4VPhysicalVolume* volume = step->GetPreStepPoint()->GetPhysicalVolume();
+  const G4VProcess* process = step->GetPostStepPoint()->GetProcessDefinedStep();
+  if (auto wrapper = dynamic_cast<const G4BiasingProcessInterface*>(process)) {
+    process = wrapper->GetWrappedProcess();
+  }
+  const Key key(volume ? volume->GetLogicalVolume() : nullptr, step->GetTrack()->GetDefinition(), process);
+
+  Entry& entry = fEntries[key];
+  entry.seconds += now - fLast;
+  ++entry.steps;
+  fLast = now;
+}
+
+void StepProfiler::MergeAndClear()
+{
+  std::lock_guard<std::mutex> lock(mergeMutex);
+  for (const auto& [key, entry] : fEntries) {
+    const auto volume = std::get<0>(key);
+    const auto particle = std::get<1>(key);
+    const auto process = std::get<2>(key);
+    Totals& totals = merged[NameKey(volume ? volume->GetName() : G4String("none"),
+                                    particle ? particle->GetParticleName() : G4String("none"),
+                                    process ? process->GetProcessName() : G4String("none"))];
+    totals.seconds += entry.seconds;
+    totals.steps += entry.steps;
+  }
+  mergedSampling = fSampling;
+  mergedTop = fTop;
+  fEntries.clear();
+}
+
+void StepProfiler::EndOfRun(G4bool isMaster)
+{
+  // 워커의 EndOfRunAction은 마스터의 EndOfRunAction보다 먼저 끝납니다.
+  if (threadProfiler && threadProfiler->IsEnabled()) threadProfiler->MergeAndClear();
+  if (!isMaster) return;
+
+  std::map<NameKey, Totals> table;
+  {
+    std::lock_guard<std::mutex> lock(mergeMutex);
+    table.swap(merged);
+  }
+  if (table.empty()) return;
+
+  G4double total = 0.;
+  G4long steps = 0;
+  std::map<G4String, Totals> triples;
+  std::map<G4String, Totals> volumeParticle;
+  std::map<G4String, Totals> particles;
+  for (const auto& [key, totals] : table) {
+    total += totals.seconds;
+    steps += totals.steps;
+    const auto& [volume, particle, process] = key;
+    triples[volume + " / " + particle + " / " + process] = totals;
+    for (Totals* rollup : {&volumeParticle[volume + " / " + particle], &particles[particle]}) {
+      rollup->seconds += totals.seconds;
+      rollup->steps += totals.steps;
+    }
+  }
+  if (total <= 0.) return;
+
+  G4cout << "------------------- Step CPU time profile -------------------" << G4endl;
+  G4cout << " " << steps << " steps timed, " << total << " CPU s summed over threads (1 of every "
+         << mergedSampling << " tracks)" << G4endl;
+  G4cout << " By volume / particle / process:" << G4endl;
+  PrintTable(SortByTime(triples), total, mergedTop);
+  G4cout << " By volume / particle:" << G4endl;
+  PrintTable(SortByTime(volumeParticle), total, mergedTop);
+  G4cout << " By particle:" << G4endl;
+  PrintTable(SortByTime(particles), total, mergedTop);
+  G4cout << "--------------------------------------------------------------" << G4endl;
+}
@@ -1,8 +1,85 @@
 #include "SteppingAction.hh"
+#include "EventAction.hh"
+#include "SlowEventMonitor.hh"
+#include "StepProfiler.hh"
+#include "TrackKiller.hh"
+#include "G4BiasingProcessInterface.hh"
+#include "G4Gamma.hh"
+#include "G4HadronicProcess.hh"
+#include "G4HadronicProcessType.hh"
+#include "G4Isotope.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Neutron.hh"
 #include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
 
-SteppingAction::SteppingAction() : G4UserSteppingAction() {}
+SteppingAction::SteppingAction(EventAction* eventAction)
+: G4UserSteppingAction(),
+  fEventAction(eventAction),
+  fSlowEvents(eventAction ? eventAction->GetSlowEventMonitor() : nullptr),
+  fTrackKiller(std::make_unique<TrackKiller>()),
+  fProfiler(std::make_unique<StepProfiler>())
+{}
 
 SteppingAction::~SteppingAction() {}
 
-void SteppingAction::UserSteppingAction(const G4Step* /*step*/) {}
+void SteppingAction::UserSteppingAction(const G4Step* step)
+{
+  // 아래의 포획 기록과 TrackKiller 검사 시간은 같은 트랙의 다음 스텝 시간에 들어갑니다.
+  fProfiler->Step(step);
+
+  G4Track* track = step->GetTrack();
+  if (fSlowEvents && fSlowEvents->IsEnabled()) fSlowEvents->CountStep(track);
+  if (track->GetDefinition() == G4Neutron::Definition()) RecordNeutronCapture(step);
+
+  // 월드 밖으로 나간 트랙은 Geant4가 알아서 제거합니다.
+  auto volume = step->GetPostStepPoint()->GetPhysicalVolume();
+  if (!volume) return;
+
+  G4TrackStatus status = fTrackKiller->CheckStep(track, volume->GetLogicalVolume()->GetRegion());
+  if (status == fAlive) return;
+
+  // 남은 운동 에너지는 버려집니다 (기록되는 영역에서는 에너지 기준을 낮게 두십시오).
+  track->SetKineticEnergy(0.);
+  track->SetTrackStatus(status);
+}
+
+void SteppingAction::RecordNeutronCapture(const G4Step* step)
+{
+  if (!fEventAction) return;
+
+  // Gd 포획 biasing이 켜지면 nCapture는 G4BiasingProcessInterface로 감싸져 있습니다.
+  const G4VProcess* process = step->GetPostStepPoint()->GetProcessDefinedStep();
+  if (auto wrapper = dynamic_cast<const G4BiasingProcessInterface*>(process)) {
+    process = wrapper->GetWrappedProcess();
+  }
+  if (!process || process->GetProcessSubType() != fCapture) return;
+
+  G4int targetZ = 0;
+  G4int targetA = 0;
+  // G4HadronicProcess::GetTargetIsotope()는 const가 아니므로 const_cast를 거칩니다 (상태는 바꾸지 않음).
+  if (auto hadronic = dynamic_cast<G4HadronicProcess*>(const_cast<G4VProcess*>(process))) {
+    if (auto isotope = hadronic->GetTargetIsotope()) {
+      targetZ = isotope->GetZ();
+      targetA = isotope->GetN();
+    }
+  }
+
+  // 이 스텝에서 만들어진 감마가 포획 cascade입니다 (ANNRI-Gd 또는 표준 모델).
+  G4int nGammas = 0;
+  G4double gammaEnergy = 0.;
+  G4double weight = step->GetPostStepPoint()->GetWeight();
+  if (auto secondaries = step->GetSecondaryInCurrentStep()) {
+    for (const G4Track* secondary : *secondaries) {
+      if (secondary->GetDefinition() != G4Gamma::Definition()) continue;
+      ++nGammas;
+      gammaEnergy += secondary->GetKineticEnergy();
+      weight = secondary->GetWeight();
+    }
+  }
+
+  const G4StepPoint* post = step->GetPostStepPoint();
+  fEventAction->AddNeutronCapture(post->GetPosition(), post->GetGlobalTime(), targetZ, targetA,
+                                  nGammas, gammaEnergy, weight);
+}
@@ -0,0 +1,170 @@
+#include "TrackKiller.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4Region.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4UIcommand.hh"
+
+#include <cmath>
+#include <sstream>
+
+namespace {
+const G4String kWildcard = "all";
+
+// 영역 이름을 DetectorConstruction의 /myApp/region/ 명령어와 같은 규칙으로 G4Region 이름으로 바꿉니다.
+G4String CanonicalRegionName(const G4String& name)
+{
+  if (name == kWildcard) return name;
+  if (name == "World") return "DefaultRegionForTheWorld";
+  const G4String suffix = "Region";
+  if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+    return name;
+  }
+  return name + suffix;
+}
+}
+
+TrackKiller::TrackKiller()
+: fEnabled(true),
+  fKillOutsideEnvelope(false),
+  fEnvelopeMargin(10.0 * cm)
+{
+  // 세그먼트 배열과 양 끝 PMT를 감싸는 상자 (DetectorConstruction::Construct()의 배치와 동일)
+  using DC = DetectorConstruction;
+  const G4double pitchX = DC::kSegmentWidth + DC::kSegmentGap;
+  const G4double pitchY = DC::kSegmentHeight + DC::kSegmentGap;
+  fEnvelopeHalfSize = G4ThreeVector((DC::kNx - 1) / 2.0 * pitchX + DC::kSegmentWidth / 2,
+                                    (DC::kNy - 1) / 2.0 * pitchY + DC::kSegmentHeight / 2,
+                                    DC::kSegmentLength / 2 + DC::kGreaseThickness + DC::kPmtHeight);
+  DefineCommands();
+}
+
+TrackKiller::~TrackKiller() {}
+
+void TrackKiller::DefineCommands()
+{
+  fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/killer/", "Track killing policies");
+  fMessenger->DeclareProperty("enable", fEnabled, "Enable or disable all killing policies");
+  fMessenger->DeclareMethod("timeWindow", &TrackKiller::SetTimeWindow,
+                            "Kill tracks beyond a global time: <particle|all> <region|all> <value> <unit>");
+  fMessenger->DeclareMethod("minEkine", &TrackKiller::SetMinEkine,
+                            "Kill tracks below a kinetic energy: <particle|all> <region|all> <value> <unit>");
+  fMessenger->DeclareProperty("killOutsideEnvelope", fKillOutsideEnvelope,
+                              "Kill tracks leaving the box around the segment array");
+  fMessenger->DeclarePropertyWithUnit("envelopeMargin", "mm", fEnvelopeMargin,
+                                      "Margin added to the detector envelope box");
+  fMessenger->DeclareMethod("list", &TrackKiller::List, "Print the configured killing rules");
+}
+
+G4bool TrackKiller::ParseRule(const G4String& args, RuleKey& key, G4double& value) const
+{
+  std::istringstream is(args);
+  G4String particle, region, unit;
+  if (!(is >> particle >> region >> value >> unit)) {
+    G4cout << "### /myApp/killer: expected <particle|all> <region|all> <value> <unit>, got \"" << args << "\"" << G4endl;
+    return false;
+  }
+  key = RuleKey(particle, CanonicalRegionName(region));
+  value *= G4UIcommand::ValueOf(unit);
+  return true;
+}
+
+void TrackKiller::SetTimeWindow(const G4String& args)
+{
+  RuleKey key;
+  G4double value = 0.;
+  if (!ParseRule(args, key, value)) return;
+  fTimeRules[key] = value;
+  fPolicyCache.clear();
+}
+
+void TrackKiller::SetMinEkine(const G4String& args)
+{
+  RuleKey key;
+  G4double value = 0.;
+  if (!ParseRule(args, key, value)) return;
+  fEkinRules[key] = value;
+  fPolicyCache.clear();
+}
+
+void TrackKiller::List()
+{
+  G4cout << "### TrackKiller " << (fEnabled ? "enabled" : "disabled") << G4endl;
+  for (const auto& rule : fTimeRules) {
+    G4cout << "  timeWindow " << rule.first.first << " " << rule.first.second << " " << rule.second / ns << " ns" << G4endl;
+  }
+  for (const auto& rule : fEkinRules) {
+    G4cout << "  minEkine " << rule.first.first << " " << rule.first.second << " " << rule.second / keV << " keV" << G4endl;
+  }
+  if (fKillOutsideEnvelope) {
+    G4cout << "  envelope half size (mm): " << fEnvelopeHalfSize / mm << " + margin " << fEnvelopeMargin / mm << G4endl;
+  }
+}
+
+G4double TrackKiller::Resolve(const std::map<RuleKey, G4double>& rules, const G4String& particle,
+                              const G4String& region, G4bool optical, G4double fallback) const
+{
+  // 가장 구체적인 규칙부터 찾습니다: (입자, 영역) > (입자, all) > (all, 영역) > (all, all)
+  const RuleKey candidates[] = {{particle, region}, {particle, kWildcard}, {kWildcard, region}, {kWildcard, kWildcard}};
+  const G4int nCandidates = optical ? 2 : 4;
+  for (G4int i = 0; i < nCandidates; ++i) {
+    auto it = rules.find(candidates[i]);
+    if (it != rules.end()) return it->second;
+  }
+  return fallback;
+}
+
+const TrackKiller::Policy& TrackKiller::GetPolicy(const G4ParticleDefinition* particle, const G4Region* region)
+{
+  const CacheKey key(particle, region);
+  auto it = fPolicyCache.find(key);
+  if (it != fPolicyCache.end()) return it->second;
+
+  const G4String& particleName = particle->GetParticleName();
+  const G4String regionName = region ? region->GetName() : G4String("");
+  const G4bool optical = (particle == G4OpticalPhoton::Definition());
+
+  Policy policy;
+  policy.maxTime = Resolve(fTimeRules, particleName, regionName, optical, DBL_MAX);
+  policy.minEkine = Resolve(fEkinRules, particleName, regionName, optical, 0.);
+  return fPolicyCache.emplace(key, policy).first->second;
+}
+
+G4bool TrackKiller::IsLeavingEnvelope(const G4Track* track) const
+{
+  const G4ThreeVector& pos = track->GetPosition();
+  const G4ThreeVector& dir = track->GetMomentumDirection();
+  for (G4int axis = 0; axis < 3; ++axis) {
+    // 어느 한 축이라도 상자 밖에서 바깥쪽으로 움직이면 다시 돌아올 수 없습니다 (월드는 공기뿐).
+    if (std::abs(pos[axis]) > fEnvelopeHalfSize[axis] + fEnvelopeMargin && pos[axis] * dir[axis] > 0.) return true;
+  }
+  return false;
+}
+
+G4bool TrackKiller::ShouldKillAtBirth(const G4Track* track)
+{
+  if (!fEnabled) return false;
+  const G4Region* region = nullptr;
+  if (auto volume = track->GetVolume()) region = volume->GetLogicalVolume()->GetRegion();
+  return track->GetGlobalTime() > GetPolicy(track->GetDefinition(), region).maxTime;
+}
+
+G4TrackStatus TrackKiller::CheckStep(const G4Track* track, const G4Region* region)
+{
+  if (!fEnabled || track->GetTrackStatus() != fAlive) return fAlive;
+  const Policy& policy = GetPolicy(track->GetDefinition(), region);
+  if (track->GetGlobalTime() > policy.maxTime) return fStopAndKill;
+  if (fKillOutsideEnvelope && IsLeavingEnvelope(track)) return fStopAndKill;
+  if (track->GetKineticEnergy() < policy.minEkine) {
+    auto processManager = track->GetDefinition()->GetProcessManager();
+    const G4bool hasAtRest = processManager && processManager->GetAtRestProcessVector()->entries() > 0;
+    return hasAtRest ? fStopButAlive : fStopAndKill;
+  }
+  return fAlive;
+}
@@ -1,10 +1,21 @@
 #include "TrackingAction.hh"
+#include "StepProfiler.hh"
+#include "TrackKiller.hh"
 #include "G4Track.hh"
+#include "G4TrackingManager.hh"
 
-TrackingAction::TrackingAction() : G4UserTrackingAction() {}
+TrackingAction::TrackingAction(TrackKiller* killer, StepProfiler* profiler)
+: G4UserTrackingAction(), fTrackKiller(killer), fProfiler(profiler)
+{}
 
 TrackingAction::~TrackingAction() {}
 
-void TrackingAction::PreUserTrackingAction(const G4Track* /*track*/) {}
+void TrackingAction::PreUserTrackingAction(const G4Track* track)
+{
+  if (fTrackKiller && fTrackKiller->ShouldKillAtBirth(track)) {
+    fpTrackingManager->GetTrack()->SetTrackStatus(fStopAndKill);
+  }
+  if (fProfiler) fProfiler->StartTrack(track);
+}
 
 void TrackingAction::PostUserTrackingAction(const G4Track* /*track*/) {}
@@ -0,0 +1,104 @@
+#include "TriggerFilter.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <atomic>
+
+namespace {
+// 모든 워커의 트리거 통계. 이벤트마다 한 번씩만 갱신하므로 원자적 카운터로 충분합니다.
+enum Reason { kEdep = 0, kSegments, kCapture, kNumReasons };
+const char* const kReasonNames[kNumReasons] = {"minEdep", "segment coincidence", "neutron capture"};
+
+std::atomic<G4long> nEvaluated(0);
+std::atomic<G4long> nAccepted(0);
+std::atomic<G4long> nRejected[kNumReasons];
+
+constexpr G4int kGadoliniumZ = 64;
+}
+
+TriggerFilter::TriggerFilter()
+: fEnabled(false),
+  fMinEdep(0.),
+  fMinSegmentPE(1),
+  fRequireBothPMTs(false),
+  fMinSegments(0),
+  fRequireCapture("none")
+{
+  DefineCommands();
+}
+
+TriggerFilter::~TriggerFilter() {}
+
+void TriggerFilter::DefineCommands()
+{
+  fMessenger = std::make_unique<G4GenericMessenger>(this, "/myApp/trigger/", "Online event trigger");
+  fMessenger->DeclareProperty("enable", fEnabled, "Write only events that pass the trigger conditions");
+  fMessenger->DeclarePropertyWithUnit("minEdep", "MeV", fMinEdep, "Minimum summed energy deposit in the LS");
+  auto& peCmd = fMessenger->DeclareProperty("minSegmentPE", fMinSegmentPE,
+      "Photoelectrons (both PMTs together) needed for a segment to fire");
+  peCmd.SetRange("minSegmentPE>=1");
+  fMessenger->DeclareProperty("requireBothPMTs", fRequireBothPMTs,
+      "A segment fires only if both of its PMTs see at least one photoelectron");
+  auto& segCmd = fMessenger->DeclareProperty("minSegments", fMinSegments,
+      "Minimum number of fired segments (0 disables the condition)");
+  segCmd.SetRange("minSegments>=0");
+  auto& captureCmd = fMessenger->DeclareProperty("requireCapture", fRequireCapture,
+      "Require a neutron capture in the event: none, any, Gd");
+  captureCmd.SetCandidates("none any Gd");
+}
+
+G4bool TriggerFilter::Accept(const EventSummaryRecord& summary, const std::vector<G4int>& channelPE)
+{
+  if (!fEnabled) return true;
+  nEvaluated.fetch_add(1, std::memory_order_relaxed);
+
+  // 싼 조건부터 검사하고, 처음 실패한 조건을 거절 사유로 셉니다.
+  G4int reason = kNumReasons;
+  if (summary.edepTotal < fMinEdep / MeV) {
+    reason = kEdep;
+  }
+  else if (fRequireCapture != "none" &&
+           (summary.nCaptures == 0 || (fRequireCapture == "Gd" && summary.captureTargetZ != kGadoliniumZ))) {
+    reason = kCapture;
+  }
+  else if (fMinSegments > 0) {
+    G4int nFired = 0;
+    for (std::size_t channel = 0; channel + 1 < channelPE.size(); channel += 2) {
+      const G4int pe0 = channelPE[channel];
+      const G4int pe1 = channelPE[channel + 1];
+      if (pe0 + pe1 < fMinSegmentPE) continue;
+      if (fRequireBothPMTs && (pe0 == 0 || pe1 == 0)) continue;
+      ++nFired;
+    }
+    if (nFired < fMinSegments) reason = kSegments;
+  }
+
+  if (reason != kNumReasons) {
+    nRejected[reason].fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  nAccepted.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void TriggerFilter::ResetStatistics()
+{
+  nEvaluated = 0;
+  nAccepted = 0;
+  for (auto& counter : nRejected) counter = 0;
+}
+
+void TriggerFilter::PrintStatistics()
+{
+  const G4long evaluated = nEvaluated.load();
+  if (evaluated == 0) return;
+
+  G4cout << "### Trigger: " << nAccepted.load() << " of " << evaluated << " events accepted ("
+         << 100. * nAccepted.load() / evaluated << " %)" << G4endl;
+  for (G4int i = 0; i < kNumReasons; ++i) {
+    if (nRejected[i].load() > 0) {
+      G4cout << "    rejected by " << kReasonNames[i] << ": " << nRejected[i].load() << G4endl;
+    }
+  }
+}